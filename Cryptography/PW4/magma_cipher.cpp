@@ -1,9 +1,9 @@
 // magma_cipher.cpp
 #include "magma_cipher.h"
+#include "../common/instrumentation.h"
 #include <fstream>
 #include <stdexcept>
 #include <algorithm>
-#include <filesystem>
 
 constexpr uint8_t SBOX[8][16] = {
     {12, 4, 6, 2, 10, 5, 11, 9, 14, 8, 13, 7, 0, 3, 15, 1},
@@ -78,27 +78,43 @@ std::vector<uint8_t> removePKCS7Padding(const std::vector<uint8_t>& data) {
 }
 
 void processFile(const std::string& input_file, const std::string& output_file, const std::vector<uint8_t>& key, bool decrypt) {
-    auto round_keys = generateRoundKeys(key);
+    std::vector<uint32_t> round_keys;
+    {
+        INSTRUMENT_SCOPE("key_expansion");
+        round_keys = generateRoundKeys(key);
+    }
     std::ifstream in(input_file, std::ios::binary);
     std::ofstream out(output_file, std::ios::binary);
     if (!in || !out) throw std::runtime_error("Cannot open input or output file");
-    std::vector<uint8_t> buffer((std::istreambuf_iterator<char>(in)), {});
-    if (!decrypt) buffer = applyPKCS7Padding(buffer, 8);
+    std::vector<uint8_t> buffer;
+    {
+        INSTRUMENT_SCOPE("read");
+        buffer.assign(std::istreambuf_iterator<char>(in), {});
+    }
+    INSTRUMENT_COUNT("bytes_in", buffer.size());
+    if (!decrypt) {
+        INSTRUMENT_SCOPE("pad");
+        buffer = applyPKCS7Padding(buffer, 8);
+    }
+
+    if (decrypt && buffer.size() % 8 != 0) throw std::runtime_error("Ciphertext size must be a multiple of 8 bytes");
 
-    for (size_t i = 0; i < buffer.size(); i += 8) {
-        std::vector<uint8_t> block(buffer.begin() + i, buffer.begin() + i + 8);
-        auto result = processBlock(block, round_keys, decrypt);
-        out.write(reinterpret_cast<char*>(result.data()), 8);
+    std::vector<uint8_t> last_block;
+    {
+        // Запись буферизуется потоком, поэтому её время учитывается в обработке блоков
+        INSTRUMENT_SCOPE("blocks");
+        for (size_t i = 0; i < buffer.size(); i += 8) {
+            std::vector<uint8_t> block(buffer.begin() + i, buffer.begin() + i + 8);
+            auto result = processBlock(block, round_keys, decrypt);
+            if (decrypt && i + 8 == buffer.size()) last_block = result;
+            else out.write(reinterpret_cast<char*>(result.data()), 8);
+        }
     }
+    INSTRUMENT_COUNT("blocks", buffer.size() / 8);
 
     if (decrypt) {
-        out.seekp(-8, std::ios::end);
-        std::vector<uint8_t> last_block(8);
-        out.read(reinterpret_cast<char*>(last_block.data()), 8);
+        INSTRUMENT_SCOPE("unpad");
         auto unpadded = removePKCS7Padding(last_block);
-        out.seekp(-8, std::ios::end);
         out.write(reinterpret_cast<char*>(unpadded.data()), unpadded.size());
-        out.close();
-        std::filesystem::resize_file(output_file, out.tellp());
     }
 }
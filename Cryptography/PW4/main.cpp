@@ -1,9 +1,11 @@
 // main.cpp
 #include "magma_cipher.h"
+#include "../common/instrumentation.h"
 #include <iostream>
 #include <sstream>
 
-int main() {
+int main(int argc, char* argv[]) {
+    instrumentation::Session stats(argc, argv);
     std::string mode, input_file, output_file, hexkey;
     std::cout << "Mode (encrypt/decrypt): ";
     std::cin >> mode;
@@ -0,0 +1,222 @@
+// batch_rsa.cpp
+#include "batch_rsa.h"
+#include "../common/instrumentation.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+
+namespace {
+
+bool is_small_prime(uint64_t x) {
+    if (x < 2) return false;
+    for (uint64_t i = 2; i * i <= x; ++i) {
+        if (x % i == 0) return false;
+    }
+    return true;
+}
+
+// Узел дерева пакета: E — произведение показателей листьев поддерева,
+// v — произведение c_i^(E/e_i) по листьям поддерева
+struct Node {
+    BigInt E;
+    BigInt v;
+    int left = -1, right = -1;
+    size_t leaf = 0;
+};
+
+int build(vector<Node>& tree, const BatchPrivateKey& key, const vector<BatchRequest>& requests,
+          size_t lo, size_t hi) {
+    Node node;
+    if (hi - lo == 1) {
+        node.E = key.exponents[requests[lo].key_index];
+        node.v = requests[lo].c;
+        node.leaf = lo;
+    } else {
+        size_t mid = (lo + hi) / 2;
+        node.left = build(tree, key, requests, lo, mid);
+        node.right = build(tree, key, requests, mid, hi);
+        const Node& L = tree[node.left];
+        const Node& R = tree[node.right];
+        node.v = mod_pow(L.v, R.E, key.n) * mod_pow(R.v, L.E, key.n) % key.n;
+        node.E = L.E * R.E;
+    }
+    tree.push_back(node);
+    return static_cast<int>(tree.size() - 1);
+}
+
+// r = v^(1/E) узла; раскладывается на корни поддеревьев r = r_L * r_R.
+// При t = 0 mod E_L, t = 1 mod E_R: r^t = r_R * v_L^(t/E_L) * v_R^((t-1)/E_R).
+void descend(const vector<Node>& tree, int index, const BigInt& r, const BigInt& n, vector<BigInt>& out) {
+    const Node& node = tree[index];
+    if (node.left < 0) {
+        out[node.leaf] = r;
+        return;
+    }
+    const Node& L = tree[node.left];
+    const Node& R = tree[node.right];
+    BigInt t = L.E * mod_inverse(L.E % R.E, R.E);
+    BigInt known = mod_pow(L.v, t / L.E, n) * mod_pow(R.v, (t - 1) / R.E, n) % n;
+    BigInt r_right = mod_pow(r, t, n) * mod_inverse(known, n) % n;
+    BigInt r_left = r * mod_inverse(r_right, n) % n;
+    descend(tree, node.left, r_left, n, out);
+    descend(tree, node.right, r_right, n, out);
+}
+
+} // namespace
+
+RSAKey BatchPrivateKey::public_key(size_t index) const {
+    return {exponents.at(index), n};
+}
+
+RSAKey BatchPrivateKey::private_key(size_t index) const {
+    return {mod_inverse(exponents.at(index), phi), n};
+}
+
+BatchPrivateKey generate_batch_keypair(int bits, size_t count) {
+    if (count == 0) throw runtime_error("Пустой набор ключей");
+    BigInt p = generate_prime(bits / 2);
+    BigInt q = generate_prime(bits / 2);
+    while (p == q)
+        q = generate_prime(bits / 2);
+
+    BatchPrivateKey key{p * q, (p - 1) * (q - 1), {}};
+    // Разные простые показатели попарно взаимно просты; пропускаются делители phi
+    for (uint64_t e = 3; key.exponents.size() < count; e += 2) {
+        if (is_small_prime(e) && key.phi % e != 0)
+            key.exponents.push_back(e);
+    }
+    return key;
+}
+
+vector<BigInt> batch_decrypt(const BatchPrivateKey& key, const vector<BatchRequest>& requests) {
+    vector<BigInt> result(requests.size());
+    if (requests.empty()) return result;
+
+    vector<bool> used(key.exponents.size());
+    for (const auto& request : requests) {
+        if (request.key_index >= key.exponents.size())
+            throw runtime_error("Нет ключа с таким номером");
+        if (used[request.key_index])
+            throw runtime_error("Ключ повторяется в пакете");
+        used[request.key_index] = true;
+        if (request.c >= key.n)
+            throw runtime_error("Блок шифра больше модуля n");
+    }
+
+    vector<Node> tree;
+    tree.reserve(2 * requests.size());
+    int root = build(tree, key, requests, 0, requests.size());
+
+    // Единственное возведение в степень полной длины на пакет
+    BigInt r;
+    {
+        INSTRUMENT_SCOPE("exponentiation");
+        r = mod_pow(tree[root].v, mod_inverse(tree[root].E, key.phi), key.n);
+    }
+    descend(tree, root, r, key.n, result);
+    INSTRUMENT_COUNT("batch_requests", requests.size());
+    return result;
+}
+
+BatchScheduler::BatchScheduler(const BatchPrivateKey& key, Clock::duration latency_budget, size_t max_batch)
+    : key_(&key),
+      latency_budget_(latency_budget),
+      max_batch_(max_batch ? min(max_batch, key.exponents.size()) : key.exponents.size()),
+      pending_per_key_(key.exponents.size()),
+      worker_([this] { run(); }) {}
+
+BatchScheduler::~BatchScheduler() {
+    {
+        lock_guard<mutex> lock(mutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    worker_.join();
+}
+
+future<BigInt> BatchScheduler::submit(size_t key_index, BigInt c) {
+    if (key_index >= key_->exponents.size()) throw runtime_error("Нет ключа с таким номером");
+    if (c >= key_->n) throw runtime_error("Блок шифра больше модуля n");
+
+    Pending pending{key_index, move(c), {}, Clock::now()};
+    auto result = pending.result.get_future();
+    {
+        lock_guard<mutex> lock(mutex_);
+        if (pending_per_key_[key_index]++ == 0) ++distinct_keys_;
+        queue_.push_back(move(pending));
+    }
+    wake_.notify_one();
+    return result;
+}
+
+size_t BatchScheduler::batches() const {
+    lock_guard<mutex> lock(mutex_);
+    return batches_;
+}
+
+size_t BatchScheduler::requests() const {
+    lock_guard<mutex> lock(mutex_);
+    return requests_;
+}
+
+// Вызывается под блокировкой; при остановке очередь дорабатывается без ожидания
+bool BatchScheduler::batch_ready() const {
+    if (queue_.empty()) return false;
+    return stop_ || distinct_keys_ >= max_batch_ || Clock::now() - queue_.front().arrived >= latency_budget_;
+}
+
+// Вызывается под блокировкой: по одному самому старому запросу под каждым ключом
+vector<BatchScheduler::Pending> BatchScheduler::take_batch() {
+    vector<Pending> batch;
+    vector<bool> taken(key_->exponents.size());
+    deque<Pending> rest;
+    for (auto& pending : queue_) {
+        if (batch.size() < max_batch_ && !taken[pending.key_index]) {
+            taken[pending.key_index] = true;
+            if (--pending_per_key_[pending.key_index] == 0) --distinct_keys_;
+            batch.push_back(move(pending));
+        } else {
+            rest.push_back(move(pending));
+        }
+    }
+    queue_.swap(rest);
+    return batch;
+}
+
+void BatchScheduler::run() {
+    unique_lock<mutex> lock(mutex_);
+    while (true) {
+        wake_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+        if (queue_.empty()) return;
+        // Самый старый запрос извлекается только этим потоком, поэтому срок ожидания не сдвигается
+        wake_.wait_until(lock, queue_.front().arrived + latency_budget_, [this] { return batch_ready(); });
+
+        auto batch = take_batch();
+        ++batches_;
+        requests_ += batch.size();
+        lock.unlock();
+
+        vector<BatchRequest> requests;
+        requests.reserve(batch.size());
+        for (const auto& pending : batch) requests.push_back({pending.key_index, pending.c});
+        try {
+            auto results = batch_decrypt(*key_, requests);
+            for (size_t i = 0; i < batch.size(); ++i) batch[i].result.set_value(move(results[i]));
+        } catch (const exception&) {
+            // Пакет не раскладывается, если какой-то c_i не обратим по модулю n;
+            // тогда каждый запрос выполняется отдельно и получает свой результат или ошибку
+            for (auto& pending : batch) {
+                try {
+                    auto [d, n] = key_->private_key(pending.key_index);
+                    pending.result.set_value(decrypt_block(pending.c, d, n));
+                } catch (...) {
+                    pending.result.set_exception(current_exception());
+                }
+            }
+        }
+
+        lock.lock();
+    }
+}
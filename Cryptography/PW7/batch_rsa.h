@@ -0,0 +1,91 @@
+// batch_rsa.h
+#ifndef BATCH_RSA_H
+#define BATCH_RSA_H
+
+#include "rsa_cipher.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Пакетный RSA Фиата: ключи с общим модулем n и разными малыми открытыми показателями e_i
+// (попарно взаимно простыми). Расшифрование (или подпись — это та же операция c -> c^d_i)
+// нескольких запросов под разными ключами стоит одного возведения в степень полной длины
+// на пакет; остальная работа — степени порядка произведения e_i и по два обращения на узел
+// дерева пакета.
+struct BatchPrivateKey {
+    BigInt n;
+    BigInt phi;
+    std::vector<uint64_t> exponents;   // e_i, попарно взаимно простые и взаимно простые с phi
+
+    // Открытый и закрытый ключ с номером index в обычном виде ({e, n}, {d, n})
+    RSAKey public_key(size_t index) const;
+    RSAKey private_key(size_t index) const;
+};
+
+// Модуль из двух простых по bits / 2 бит и count показателей — нечётных простых начиная с 3
+BatchPrivateKey generate_batch_keypair(int bits, size_t count);
+
+struct BatchRequest {
+    size_t key_index;
+    BigInt c;
+};
+
+// m_i = c_i^d_i mod n для всех запросов; номера ключей в пакете не должны повторяться
+std::vector<BigInt> batch_decrypt(const BatchPrivateKey& key, const std::vector<BatchRequest>& requests);
+
+// Собирает поступающие запросы в пакеты и выполняет их в отдельном потоке.
+// Пакет отправляется, как только в очереди есть запросы под max_batch разными ключами,
+// или когда самый старый запрос прождал latency_budget. Запросы под одним ключом
+// попадают в разные пакеты в порядке поступления.
+class BatchScheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // key должен жить дольше планировщика; max_batch = 0 — по числу ключей
+    BatchScheduler(const BatchPrivateKey& key, Clock::duration latency_budget, size_t max_batch = 0);
+    ~BatchScheduler();
+
+    BatchScheduler(const BatchScheduler&) = delete;
+    BatchScheduler& operator=(const BatchScheduler&) = delete;
+
+    std::future<BigInt> submit(size_t key_index, BigInt c);
+
+    // Число собранных пакетов и запросов в них
+    size_t batches() const;
+    size_t requests() const;
+
+private:
+    struct Pending {
+        size_t key_index;
+        BigInt c;
+        std::promise<BigInt> result;
+        Clock::time_point arrived;
+    };
+
+    void run();
+    bool batch_ready() const;
+    std::vector<Pending> take_batch();
+
+    const BatchPrivateKey* key_;
+    Clock::duration latency_budget_;
+    size_t max_batch_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    std::deque<Pending> queue_;
+    std::vector<size_t> pending_per_key_;
+    size_t distinct_keys_ = 0;   // ключей, под которыми есть хотя бы один запрос в очереди
+    size_t batches_ = 0, requests_ = 0;
+    bool stop_ = false;
+
+    std::thread worker_;   // последним: поток стартует, когда остальные члены уже готовы
+};
+
+#endif // BATCH_RSA_H
@@ -0,0 +1,128 @@
+// bench_rsa.cpp
+// Замеры RSA: mod_pow по размеру модуля, распределение времени generate_keypair,
+// пропускная способность process_file, пакетное расшифрование Фиата.
+// Отчёт в JSON (см. common/benchmark.h).
+#include "rsa_cipher.h"
+#include "batch_rsa.h"
+#include "../common/benchmark.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+using namespace std;
+
+namespace {
+
+void bench_mod_pow(benchmark::Report& report, const benchmark::Options& options) {
+    vector<int> sizes = options.quick ? vector<int>{512, 1024} : vector<int>{512, 1024, 2048};
+    for (int bits : sizes) {
+        seed_random(options.seed + bits);
+        // Нечётный модуль полной длины; для скорости mod_pow его простота не важна
+        BigInt n = generate_random_bits(bits) | 1;
+        BigInt base = generate_random_bits(bits - 1);
+        BigInt d = generate_random_bits(bits - 1);
+
+        // Открытый показатель 65537 (шифрование) и показатель полной длины (расшифрование)
+        for (const auto& [kind, exp] : {pair<string, BigInt>{"public", 65537}, pair<string, BigInt>{"private", d}}) {
+            auto stats = benchmark::measure([&] { benchmark::do_not_optimize(mod_pow(base, exp, n)); },
+                                            options.quick ? 3 : 20, options.quick ? 0.0 : 0.5);
+            report.add("mod_pow", {{"bits", to_string(bits)}, {"exponent", kind}}, stats);
+        }
+    }
+}
+
+void bench_generate_keypair(benchmark::Report& report, const benchmark::Options& options) {
+    // Время генерации определяется поиском простых и сильно разбросано, поэтому
+    // важна не только медиана, но и хвост распределения
+    vector<pair<int, size_t>> runs = options.quick ? vector<pair<int, size_t>>{{256, 5}}
+                                                   : vector<pair<int, size_t>>{{512, 30}, {1024, 10}};
+    for (auto [bits, count] : runs) {
+        seed_random(options.seed + bits);
+        auto stats = benchmark::measure([&] { benchmark::do_not_optimize(generate_keypair(bits)); },
+                                        count, 0.0, count);
+        report.add("generate_keypair", {{"bits", to_string(bits)}}, stats);
+    }
+}
+
+void bench_process_file(benchmark::Report& report, const benchmark::Options& options) {
+    int bits = options.quick ? 512 : 1024;
+    size_t size = options.quick ? 2048 : 16384;
+
+    seed_random(options.seed);
+    auto [pub, priv] = generate_keypair(bits);
+
+    // Файлы пишутся в текущий каталог (в ctest — каталог сборки), как и отчёт;
+    // номер процесса в имени разводит параллельные запуски
+    string base = "bench_rsa_" + to_string(getpid());
+    string plain = base + ".plain";
+    string cipher = base + ".enc";
+    string decrypted = base + ".dec";
+
+    mt19937_64 data_gen(options.seed);
+    vector<char> data(size);
+    for (auto& byte : data) byte = static_cast<char>(data_gen());
+    ofstream(plain, ios::binary).write(data.data(), data.size());
+
+    size_t iterations = options.quick ? 1 : 3;
+    double seconds = options.quick ? 0.0 : 0.5;
+    auto encrypt = benchmark::measure([&] { process_file(plain, cipher, pub, "encrypt"); }, iterations, seconds);
+    report.add("process_file", {{"bits", to_string(bits)}, {"mode", "encrypt"}}, encrypt, size);
+    auto decrypt = benchmark::measure([&] { process_file(cipher, decrypted, priv, "decrypt"); }, iterations, seconds);
+    report.add("process_file", {{"bits", to_string(bits)}, {"mode", "decrypt"}}, decrypt, size);
+
+    remove(plain.c_str());
+    remove(cipher.c_str());
+    remove(decrypted.c_str());
+}
+
+// Пакет из b запросов против b отдельных расшифрований: items_per_sec сравнимо с ops_per_sec decrypt_block
+void bench_batch_decrypt(benchmark::Report& report, const benchmark::Options& options) {
+    int bits = options.quick ? 512 : 1024;
+    vector<size_t> sizes = options.quick ? vector<size_t>{1, 4} : vector<size_t>{1, 2, 4, 8, 16};
+
+    seed_random(options.seed);
+    auto key = generate_batch_keypair(bits, sizes.back());
+    vector<BatchRequest> requests;
+    for (size_t i = 0; i < sizes.back(); ++i) {
+        auto [e, n] = key.public_key(i);
+        requests.push_back({i, mod_pow(generate_random_bits(bits - 8), e, n)});
+    }
+
+    size_t iterations = options.quick ? 3 : 20;
+    double seconds = options.quick ? 0.0 : 0.5;
+    auto [d, n] = key.private_key(0);
+    auto single = benchmark::measure([&] { benchmark::do_not_optimize(decrypt_block(requests[0].c, d, n)); },
+                                     iterations, seconds);
+    report.add("decrypt_block", {{"bits", to_string(bits)}}, single);
+
+    for (size_t size : sizes) {
+        vector<BatchRequest> batch(requests.begin(), requests.begin() + size);
+        auto stats = benchmark::measure([&] { benchmark::do_not_optimize(batch_decrypt(key, batch)); },
+                                        iterations, seconds);
+        report.add("batch_decrypt", {{"bits", to_string(bits)}, {"batch", to_string(size)}}, stats, 0, size);
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    try {
+        auto options = benchmark::parse_options(argc, argv);
+        benchmark::Report report("rsa", options);
+        bench_mod_pow(report, options);
+        bench_generate_keypair(report, options);
+        bench_process_file(report, options);
+        bench_batch_decrypt(report, options);
+        report.write();
+    } catch (const exception& e) {
+        cerr << "Ошибка: " << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
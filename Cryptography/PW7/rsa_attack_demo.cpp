@@ -1,12 +1,29 @@
 // rsa_attack_demo.cpp — Современная C++17 реализация атаки на RSA с малыми модулями
+#include <boost/multiprecision/cpp_int.hpp>
+#include <boost/multiprecision/miller_rabin.hpp>
+#include <algorithm>
+#include <atomic>
 #include <cstdint>
+#include <cstring>
 #include <iostream>
+#include <iterator>
+#include <mutex>
+#include <numeric>
 #include <optional>
+#include <random>
 #include <stdexcept>
+#include <string>
+#include <thread>
 #include <tuple>
 #include <cmath>
 #include <utility>
 #include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 namespace RSAAttack {
 
@@ -77,6 +94,913 @@ inline u64 attack(u64 e, u64 n, u64 ciphertext) {
     return plaintext;
 }
 
+// ---------------------------------------------------------------------------
+// Модули среднего размера (64–200 бит): многоточная арифметика
+// ---------------------------------------------------------------------------
+
+using BigInt = boost::multiprecision::cpp_int;
+
+// Решето Эратосфена: все простые числа, не превосходящие limit
+inline std::vector<u64> primes_up_to(u64 limit) {
+    std::vector<bool> composite(limit + 1, false);
+    std::vector<u64> primes;
+    for (u64 i = 2; i <= limit; ++i) {
+        if (composite[i]) continue;
+        primes.push_back(i);
+        for (u64 j = i * i; j <= limit; j += i) {
+            composite[j] = true;
+        }
+    }
+    return primes;
+}
+
+// Обратное по модулю для BigInt; при неудаче возвращает nullopt,
+// а в gcd_out кладёт gcd(a, m) — для ECM это и есть найденный делитель
+inline std::optional<BigInt> modular_inverse(const BigInt& a, const BigInt& m, BigInt* gcd_out = nullptr) {
+    BigInt old_r = a % m, r = m;
+    BigInt old_s = 1, s = 0;
+    while (r != 0) {
+        BigInt q = old_r / r;
+        BigInt next_r = old_r - q * r;
+        old_r = r;
+        r = next_r;
+        BigInt next_s = old_s - q * s;
+        old_s = s;
+        s = next_s;
+    }
+    if (gcd_out) *gcd_out = old_r;
+    if (old_r != 1) return std::nullopt;
+    old_s %= m;
+    if (old_s < 0) old_s += m;
+    return old_s;
+}
+
+// Метод эллиптических кривых Ленстры (ECM) на кривых Монтгомери.
+// Время работы определяется размером наименьшего делителя, а не самого n.
+namespace ECM {
+
+struct Params {
+    u64 B1 = 11'000;        // граница первой стадии (оптимум для делителей ~20 цифр)
+    u64 B2 = 1'100'000;     // граница второй стадии
+    unsigned curves = 400;  // максимальное число кривых
+    unsigned threads = 0;   // 0 — по числу аппаратных потоков
+    u64 seed = 0x5EC7;      // зерно генератора параметров кривых
+};
+
+// Точка в проективных координатах (X : Z), координата y не используется
+struct XZPoint {
+    BigInt X, Z;
+};
+
+// Кривая Монтгомери B*y^2 = x^3 + A*x^2 + x по модулю n; хранится a24 = (A + 2) / 4
+class MontgomeryCurve {
+public:
+    MontgomeryCurve(const BigInt& n, const BigInt& a24) : n_(n), a24_(a24) {}
+
+    BigInt mulmod(const BigInt& a, const BigInt& b) const { return (a * b) % n_; }
+    BigInt addmod(const BigInt& a, const BigInt& b) const {
+        BigInt r = a + b;
+        if (r >= n_) r -= n_;
+        return r;
+    }
+    BigInt submod(const BigInt& a, const BigInt& b) const {
+        BigInt r = a - b;
+        if (r < 0) r += n_;
+        return r;
+    }
+
+    // Удвоение: 2P
+    XZPoint dbl(const XZPoint& P) const {
+        BigInt s = mulmod(addmod(P.X, P.Z), addmod(P.X, P.Z));
+        BigInt d = mulmod(submod(P.X, P.Z), submod(P.X, P.Z));
+        BigInt t = submod(s, d);
+        return {mulmod(s, d), mulmod(t, addmod(d, mulmod(a24_, t)))};
+    }
+
+    // Дифференциальное сложение: P + Q при известной разности P - Q
+    XZPoint add(const XZPoint& P, const XZPoint& Q, const XZPoint& diff) const {
+        BigInt u = mulmod(submod(P.X, P.Z), addmod(Q.X, Q.Z));
+        BigInt v = mulmod(addmod(P.X, P.Z), submod(Q.X, Q.Z));
+        BigInt sum = addmod(u, v), dif = submod(u, v);
+        return {mulmod(diff.Z, mulmod(sum, sum)), mulmod(diff.X, mulmod(dif, dif))};
+    }
+
+    // Лестница Монтгомери: k*P только по координате x
+    XZPoint ladder(const XZPoint& P, u64 k) const {
+        if (k == 1) return P;
+        XZPoint R0 = P, R1 = dbl(P);
+        for (int bit = 62 - __builtin_clzll(k); bit >= 0; --bit) {
+            if ((k >> bit) & 1) {
+                R0 = add(R1, R0, P);
+                R1 = dbl(R1);
+            } else {
+                R1 = add(R0, R1, P);
+                R0 = dbl(R0);
+            }
+        }
+        return R0;
+    }
+
+private:
+    BigInt n_, a24_;
+};
+
+// Общие для всех кривых данные: простые до B1 и решето до B2
+struct SharedTables {
+    std::vector<u64> primes_b1;
+    std::vector<bool> is_prime_b2;
+};
+
+constexpr u64 kStage2D = 2310;   // шаг второй стадии: 2*3*5*7*11
+
+// Одна кривая с параметризацией Суямы по sigma. Возвращает нетривиальный делитель n или nullopt.
+inline std::optional<BigInt> run_curve(const BigInt& n, const BigInt& sigma, const Params& params,
+                                       const SharedTables& tables, const std::atomic<bool>& stop) {
+    auto nontrivial = [&n](const BigInt& g) -> std::optional<BigInt> {
+        if (g > 1 && g < n) return g;
+        return std::nullopt;
+    };
+
+    // u = sigma^2 - 5, v = 4*sigma, x0 = u^3 / v^3, a24 = (v - u)^3 (3u + v) / (16 u^3 v)
+    BigInt u = (sigma * sigma - 5) % n;
+    BigInt v = (4 * sigma) % n;
+    BigInt u3 = (u * u % n) * u % n;
+    BigInt v3 = (v * v % n) * v % n;
+    BigInt vu = (v - u + n) % n;
+    BigInt num = (vu * vu % n) * vu % n * ((3 * u + v) % n) % n;
+    BigInt den = (16 * u3 % n) * v % n;
+    BigInt g;
+    auto den_inv = modular_inverse(den, n, &g);
+    if (!den_inv) return nontrivial(g);
+
+    MontgomeryCurve curve(n, num * *den_inv % n);
+    XZPoint P{u3, v3};
+
+    // Стадия 1: P <- (произведение p^e <= B1) * P
+    for (u64 p : tables.primes_b1) {
+        if (stop.load(std::memory_order_relaxed)) return std::nullopt;
+        u64 pe = p;
+        while (pe <= params.B1 / p) pe *= p;
+        P = curve.ladder(P, pe);
+    }
+    g = boost::multiprecision::gcd(P.Z, n);
+    if (g != 1) return nontrivial(g);
+
+    // Стадия 2: один простой q в (B1, B2] в виде q = m*D +- j.
+    // Таблица j*P для нечётных j < D/2, взаимно простых с D
+    std::vector<u64> js;
+    std::vector<XZPoint> jP;
+    {
+        XZPoint P2 = curve.dbl(P);
+        XZPoint prev = P, cur = curve.add(P2, P, P);   // 1P, 3P
+        js.push_back(1);
+        jP.push_back(P);
+        for (u64 j = 3; j < kStage2D / 2; j += 2) {
+            if (std::gcd(j, kStage2D) == 1) {
+                js.push_back(j);
+                jP.push_back(cur);
+            }
+            XZPoint next = curve.add(cur, P2, prev);
+            prev = cur;
+            cur = next;
+        }
+    }
+
+    u64 m = std::max<u64>(params.B1 / kStage2D, 1);
+    XZPoint DP = curve.ladder(P, kStage2D);
+    XZPoint R = curve.ladder(P, m * kStage2D);
+    XZPoint R_prev = (m > 1) ? curve.ladder(P, (m - 1) * kStage2D) : P;   // при m == 1 не используется
+    BigInt acc = 1;
+    for (; m * kStage2D <= params.B2 + kStage2D / 2; ++m) {
+        if (stop.load(std::memory_order_relaxed)) return std::nullopt;
+        u64 base = m * kStage2D;
+        for (std::size_t i = 0; i < js.size(); ++i) {
+            u64 lo = base - js[i], hi = base + js[i];
+            bool hit = (lo > params.B1 && lo <= params.B2 && tables.is_prime_b2[lo]) ||
+                       (hi > params.B1 && hi <= params.B2 && tables.is_prime_b2[hi]);
+            if (!hit) continue;
+            // x(R) == x(jP) по модулю делителя  <=>  X_R*Z_j - X_j*Z_R == 0
+            acc = acc * curve.submod(curve.mulmod(R.X, jP[i].Z), curve.mulmod(jP[i].X, R.Z)) % n;
+        }
+        XZPoint next = (m == 1) ? curve.dbl(R) : curve.add(R, DP, R_prev);
+        R_prev = R;
+        R = next;
+    }
+    return nontrivial(boost::multiprecision::gcd(acc, n));
+}
+
+// Параллельный поиск делителя: кривые распределяются по потокам,
+// все потоки останавливаются, как только один из них нашёл делитель
+inline std::optional<BigInt> find_factor(const BigInt& n, const Params& params = {}) {
+    if (params.B1 < kStage2D || params.B2 < params.B1) {
+        throw std::invalid_argument("ECM requires B1 >= 2310 and B2 >= B1");
+    }
+
+    SharedTables tables;
+    tables.primes_b1 = primes_up_to(params.B1);
+    tables.is_prime_b2.assign(params.B2 + 1, true);
+    tables.is_prime_b2[0] = tables.is_prime_b2[1] = false;
+    for (u64 i = 2; i * i <= params.B2; ++i) {
+        if (!tables.is_prime_b2[i]) continue;
+        for (u64 j = i * i; j <= params.B2; j += i) tables.is_prime_b2[j] = false;
+    }
+
+    unsigned threads = params.threads ? params.threads : std::max(1u, std::thread::hardware_concurrency());
+    std::atomic<bool> stop{false};
+    std::atomic<unsigned> next_curve{0};
+    std::mutex result_mutex;
+    std::optional<BigInt> result;
+
+    auto worker = [&] {
+        for (unsigned idx; !stop.load() && (idx = next_curve.fetch_add(1)) < params.curves;) {
+            // Детерминированное sigma для каждой кривой — прогон воспроизводим при любом числе потоков
+            std::mt19937_64 rng(params.seed + idx);
+            BigInt sigma = 6 + BigInt(rng()) % (n - 7);
+            auto factor = run_curve(n, sigma, params, tables, stop);
+            if (factor) {
+                std::lock_guard<std::mutex> lock(result_mutex);
+                if (!result) result = factor;
+                stop = true;
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned i = 0; i < threads; ++i) pool.emplace_back(worker);
+    for (auto& t : pool) t.join();
+    return result;
+}
+
+} // namespace ECM
+
+// Самоинициализирующееся квадратичное решето (SIQS) для модулей 100–200 бит.
+// В отличие от ECM, время работы зависит только от размера n, а не от меньшего множителя,
+// поэтому SIQS — основной метод для «сбалансированных» модулей, где оба множителя одного размера.
+namespace QS {
+
+using u8 = std::uint8_t;
+using u32 = std::uint32_t;
+
+struct Params {
+    unsigned threads = 0;           // 0 — по числу аппаратных потоков
+    u64 seed = 0x51E5;              // зерно выбора коэффициентов a
+    unsigned factor_base_size = 0;  // 0 — по таблице для размера n
+    unsigned sieve_blocks = 0;      // 0 — по таблице для размера n
+};
+
+constexpr std::size_t kBlockSize = 1 << 15;   // блок решета, помещается в L1-кэш
+constexpr u32 kSmallPrimeBound = 50;           // простые меньше границы не просеиваются
+constexpr std::size_t kExtraRelations = 64;    // запас соотношений сверх размера базы
+
+// Параметры по битовой длине n: размер факторной базы, число блоков на
+// половину интервала [-M, M) и множитель границы больших простых
+struct SizeParams {
+    unsigned bits, fb_size, blocks, lp_mult;
+};
+
+constexpr SizeParams kSizeTable[] = {
+    { 64,  100,  1,  30}, { 80,  150,  1,  30}, {100,  250,  1,  40},
+    {120,  450,  2,  50}, {140,  800,  2,  60}, {160, 1300,  4,  70},
+    {180, 2000,  6,  80}, {200, 3000,  8, 100}, {230, 4500, 10, 120},
+};
+
+inline const SizeParams& size_params(unsigned bits) {
+    for (const auto& row : kSizeTable) {
+        if (bits <= row.bits) return row;
+    }
+    return kSizeTable[std::size(kSizeTable) - 1];
+}
+
+inline u32 mulmod32(u32 a, u32 b, u32 p) {
+    return static_cast<u32>(static_cast<u64>(a) * b % p);
+}
+
+inline u32 powmod32(u32 base, u32 exp, u32 p) {
+    u32 result = 1;
+    for (; exp; exp >>= 1) {
+        if (exp & 1) result = mulmod32(result, base, p);
+        base = mulmod32(base, base, p);
+    }
+    return result;
+}
+
+inline u32 inverse32(u32 a, u32 p) {
+    return powmod32(a % p, p - 2, p);
+}
+
+// Символ Лежандра (a/p) для нечётного простого p
+inline int legendre(u32 a, u32 p) {
+    a %= p;
+    if (a == 0) return 0;
+    return powmod32(a, (p - 1) / 2, p) == 1 ? 1 : -1;
+}
+
+// Квадратный корень по модулю простого p (Тонелли — Шенкс)
+inline u32 sqrt_mod(u32 a, u32 p) {
+    a %= p;
+    if (p == 2 || a == 0) return a;
+    if (p % 4 == 3) return powmod32(a, (p + 1) / 4, p);
+    u32 q = p - 1, s = 0;
+    while (q % 2 == 0) { q /= 2; ++s; }
+    u32 z = 2;
+    while (legendre(z, p) != -1) ++z;
+    u32 m = s, c = powmod32(z, q, p), t = powmod32(a, q, p), r = powmod32(a, (q + 1) / 2, p);
+    while (t != 1) {
+        u32 i = 0;
+        for (u32 t2 = t; t2 != 1; t2 = mulmod32(t2, t2, p)) ++i;
+        u32 b = c;
+        for (u32 j = 0; j + 1 < m - i; ++j) b = mulmod32(b, b, p);
+        m = i;
+        c = mulmod32(b, b, p);
+        t = mulmod32(t, c, p);
+        r = mulmod32(r, b, p);
+    }
+    return r;
+}
+
+inline u32 mod_small(const BigInt& x, u32 p) {
+    BigInt r = x % p;
+    if (r < 0) r += p;
+    return static_cast<u32>(r);
+}
+
+// Множитель Кнута — Шрёппеля: k, при котором у kN больше всего малых квадратичных вычетов
+inline u32 choose_multiplier(const BigInt& n) {
+    static constexpr u32 candidates[] = {1, 3, 5, 7, 11, 13, 15, 17, 19, 21, 23, 29, 31, 33, 35, 37,
+                                         39, 41, 43, 47, 51, 53, 55, 57, 59, 61, 65, 67, 69, 71, 73};
+    const auto primes = primes_up_to(1000);
+    u32 best = 1;
+    double best_score = -1e9;
+    for (u32 k : candidates) {
+        BigInt kn = n * k;
+        double score = -0.5 * std::log(static_cast<double>(k));
+        u32 mod8 = mod_small(kn, 8);
+        if (mod8 == 1) score += 2 * std::log(2.0);
+        else if (mod8 == 5) score += std::log(2.0);
+        else if (mod8 == 3 || mod8 == 7) score += 0.5 * std::log(2.0);
+        for (std::size_t i = 1; i < primes.size(); ++i) {
+            u32 p = static_cast<u32>(primes[i]);
+            double lp = std::log(static_cast<double>(p));
+            if (k % p == 0) score += lp / p;
+            else if (legendre(mod_small(kn, p), p) == 1) score += 2 * lp / (p - 1);
+        }
+        if (score > best_score) {
+            best_score = score;
+            best = k;
+        }
+    }
+    return best;
+}
+
+// Факторная база: простые p, для которых kN — квадратичный вычет
+struct FactorBase {
+    BigInt n, kn;
+    u32 multiplier = 1;
+    std::vector<u32> primes;
+    std::vector<u32> sqrts;   // sqrt(kN) mod p
+    std::vector<u8> logs;     // округлённый log2(p)
+    std::size_t sieve_start = 0;   // индекс первого просеиваемого простого
+
+    FactorBase(const BigInt& n_, std::size_t size) : n(n_) {
+        multiplier = choose_multiplier(n);
+        kn = n * multiplier;
+        primes.push_back(2);
+        sqrts.push_back(mod_small(kn, 2));
+        for (u64 bound = 1024; primes.size() < size; bound *= 2) {
+            for (u64 p64 : primes_up_to(bound)) {
+                u32 p = static_cast<u32>(p64);
+                if (p <= primes.back()) continue;
+                u32 r = mod_small(kn, p);
+                if (r != 0 && legendre(r, p) != 1) continue;
+                primes.push_back(p);
+                sqrts.push_back(sqrt_mod(r, p));
+                if (primes.size() == size) break;
+            }
+        }
+        for (u32 p : primes) {
+            logs.push_back(static_cast<u8>(std::lround(std::log2(static_cast<double>(p)))));
+        }
+        while (sieve_start < primes.size() && primes[sieve_start] < kSmallPrimeBound) ++sieve_start;
+    }
+};
+
+// Соотношение y^2 ≡ (-1)^e0 * prod p_j * L^2 (mod N). В factors — индексы столбцов
+// с повторениями: 0 — знак, j + 1 — j-е простое базы. large — произведение больших простых
+struct Relation {
+    BigInt y;
+    std::vector<u32> factors;
+    BigInt large = 1;
+};
+
+// Общее хранилище соотношений: полные и частичные (с одним большим простым)
+class RelationStore {
+public:
+    RelationStore(const BigInt& n, std::size_t target) : n_(n), target_(target) {}
+
+    bool done() const { return done_.load(std::memory_order_relaxed); }
+
+    void add_full(Relation rel) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        push(std::move(rel));
+    }
+
+    // Два частичных соотношения с одним и тем же L дают полное: L входит в произведение в квадрате
+    void add_partial(u64 large_prime, Relation rel) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = partials_.find(large_prime);
+        if (it == partials_.end()) {
+            partials_.emplace(large_prime, std::move(rel));
+            return;
+        }
+        Relation combined;
+        combined.y = (it->second.y * rel.y) % n_;
+        combined.factors = it->second.factors;
+        combined.factors.insert(combined.factors.end(), rel.factors.begin(), rel.factors.end());
+        combined.large = large_prime;
+        ++combined_;
+        push(std::move(combined));
+    }
+
+    std::vector<Relation> take() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return std::move(full_);
+    }
+
+    std::size_t combined() const { return combined_; }
+
+private:
+    void push(Relation rel) {
+        if (done()) return;
+        full_.push_back(std::move(rel));
+        if (full_.size() >= target_) done_ = true;
+    }
+
+    BigInt n_;
+    std::size_t target_;
+    std::mutex mutex_;
+    std::vector<Relation> full_;
+    std::unordered_map<u64, Relation> partials_;
+    std::size_t combined_ = 0;
+    std::atomic<bool> done_{false};
+};
+
+// Поиск кандидатов в блоке: позиции, где накопленные логарифмы перешли порог
+// (старший бит байта выставлен). SSE2 проверяет 16 байт за инструкцию, без SSE2 — по 8 байт в u64
+inline void scan_block(const u8* sieve, std::size_t size, std::vector<u32>& out) {
+    out.clear();
+#if defined(__SSE2__)
+    for (std::size_t i = 0; i < size; i += 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sieve + i));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(chunk));
+        while (mask) {
+            out.push_back(static_cast<u32>(i + __builtin_ctz(mask)));
+            mask &= mask - 1;
+        }
+    }
+#else
+    for (std::size_t i = 0; i < size; i += 8) {
+        u64 word;
+        std::memcpy(&word, sieve + i, sizeof(word));
+        word &= 0x8080808080808080ULL;
+        while (word) {
+            out.push_back(static_cast<u32>(i + __builtin_ctzll(word) / 8));
+            word &= word - 1;
+        }
+    }
+#endif
+}
+
+// Поток просеивания: перебирает собственные коэффициенты a и все 2^(s-1) значения b для каждого
+class SieveWorker {
+public:
+    SieveWorker(const FactorBase& fb, const SizeParams& sp, unsigned blocks, u64 seed,
+                RelationStore& store, std::mutex& a_mutex, std::unordered_set<u64>& used_a)
+        : fb_(fb), store_(store), a_mutex_(a_mutex), used_a_(used_a), rng_(seed),
+          interval_(2 * blocks * kBlockSize), half_(blocks * kBlockSize) {
+        const std::size_t F = fb.primes.size();
+        root1_.resize(F); root2_.resize(F);
+        next1_.resize(F); next2_.resize(F);
+        ainv_.resize(F);
+        skip_.resize(F);
+        sieve_.resize(kBlockSize);
+        large_bound_ = static_cast<u64>(fb.primes.back()) * sp.lp_mult;
+
+        // Порог: log2 |Q(x)/a| ~ log2(M * sqrt(kN / 2)) минус допуск на большое простое
+        // и на непросеиваемые малые простые
+        double log_q = std::log2(static_cast<double>(half_)) +
+                       0.5 * (static_cast<double>(boost::multiprecision::msb(fb.kn)) - 1.0);
+        double slack = std::log2(static_cast<double>(large_bound_)) + 4.0;
+        int threshold = static_cast<int>(log_q - slack);
+        init_ = static_cast<u8>(std::clamp(128 - threshold, 0, 127));
+
+        // Размер простых, из которых составляется a ≈ sqrt(2kN) / M
+        log_target_ = 0.5 * (static_cast<double>(boost::multiprecision::msb(fb.kn)) + 2.0) - std::log2(static_cast<double>(half_));
+    }
+
+    void run() {
+        while (!store_.done()) {
+            if (!choose_a()) return;
+            init_polynomial();
+            const std::size_t count = std::size_t(1) << (B_.size() - 1);
+            for (std::size_t i = 0; i < count && !store_.done(); ++i) {
+                if (i > 0) next_polynomial(i);
+                sieve_polynomial();
+            }
+        }
+    }
+
+private:
+    // Выбор a = q_1 * ... * q_s из простых факторной базы
+    bool choose_a() {
+        const auto& P = fb_.primes;
+        std::size_t lo = std::max<std::size_t>(fb_.sieve_start, 1);
+        std::size_t hi = P.size() - 1;
+        double log_pmax = std::log2(static_cast<double>(P[hi]));
+        double log_ideal = std::min(11.0, log_pmax - 1.0);
+        std::size_t s = std::max<std::size_t>(2, static_cast<std::size_t>(std::lround(log_target_ / log_ideal)));
+        double ideal = std::exp2(log_target_ / s);
+
+        // Окно индексов вокруг «идеального» размера простого
+        auto near = std::lower_bound(P.begin() + lo, P.end(), static_cast<u32>(std::min(ideal, double(P[hi]))));
+        std::size_t center = static_cast<std::size_t>(near - P.begin());
+        std::size_t span = std::max<std::size_t>(4 * s, 16);
+        std::size_t w_lo = center > lo + span ? center - span : lo;
+        std::size_t w_hi = std::min(hi, center + span);
+
+        for (int attempt = 0; attempt < 1000; ++attempt) {
+            std::vector<std::size_t> idx;
+            BigInt a = 1;
+            while (idx.size() + 1 < s) {
+                std::size_t j = w_lo + rng_() % (w_hi - w_lo + 1);
+                if (std::find(idx.begin(), idx.end(), j) != idx.end() || fb_.multiplier % P[j] == 0) continue;
+                idx.push_back(j);
+                a *= P[j];
+            }
+            // Последний множитель подбирается так, чтобы a было ближе всего к цели
+            double rest = std::exp2(log_target_ - std::log2(static_cast<double>(a)));
+            auto it = std::lower_bound(P.begin() + lo, P.end(), static_cast<u32>(std::min(rest, double(P[hi]))));
+            std::size_t j = std::min<std::size_t>(static_cast<std::size_t>(it - P.begin()), hi);
+            while (j > lo && (std::find(idx.begin(), idx.end(), j) != idx.end() || fb_.multiplier % P[j] == 0)) --j;
+            if (std::find(idx.begin(), idx.end(), j) != idx.end()) continue;
+            idx.push_back(j);
+            a *= P[j];
+
+            std::sort(idx.begin(), idx.end());
+            u64 key = 0;
+            for (std::size_t k : idx) key = key * 1000003 + k;
+            std::lock_guard<std::mutex> lock(a_mutex_);
+            if (used_a_.insert(key).second) {
+                a_ = a;
+                a_idx_ = idx;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Коэффициенты B_l, первое b = sum B_l и корни Q(x) ≡ 0 (mod p) для всей базы
+    void init_polynomial() {
+        const auto& P = fb_.primes;
+        const std::size_t F = P.size(), s = a_idx_.size();
+        B_.assign(s, 0);
+        b_ = 0;
+        for (std::size_t l = 0; l < s; ++l) {
+            u32 q = P[a_idx_[l]];
+            BigInt a_q = a_ / q;
+            u32 gamma = mulmod32(fb_.sqrts[a_idx_[l]], inverse32(mod_small(a_q, q), q), q);
+            if (gamma > q / 2) gamma = q - gamma;
+            B_[l] = a_q * gamma;
+            b_ += B_[l];
+        }
+        c_ = (b_ * b_ - fb_.kn) / a_;
+
+        bainv2_.assign(s, std::vector<u32>(F));
+        std::fill(skip_.begin(), skip_.end(), false);
+        for (std::size_t j : a_idx_) skip_[j] = true;
+        for (std::size_t j = 0; j < F; ++j) {
+            u32 p = P[j];
+            if (j < fb_.sieve_start || fb_.multiplier % p == 0) skip_[j] = true;
+            if (skip_[j]) continue;
+            ainv_[j] = inverse32(mod_small(a_, p), p);
+            for (std::size_t l = 0; l < s; ++l) {
+                bainv2_[l][j] = mulmod32(2 * mod_small(B_[l], p) % p, ainv_[j], p);
+            }
+            u32 bm = mod_small(b_, p), t = fb_.sqrts[j], shift = static_cast<u32>(half_ % p);
+            root1_[j] = (mulmod32(ainv_[j], (t + p - bm) % p, p) + shift) % p;
+            root2_[j] = (mulmod32(ainv_[j], (2 * p - t - bm) % p, p) + shift) % p;
+        }
+    }
+
+    // Переход к следующему b по коду Грея: b' = b ∓ 2B_v, корни сдвигаются на ±2 B_v a^-1
+    void next_polynomial(std::size_t i) {
+        std::size_t v = static_cast<std::size_t>(__builtin_ctzll(i)) + 1;
+        bool minus = ((i ^ (i >> 1)) >> (v - 1)) & 1;
+        if (minus) b_ -= 2 * B_[v];
+        else b_ += 2 * B_[v];
+        c_ = (b_ * b_ - fb_.kn) / a_;
+
+        const auto& P = fb_.primes;
+        const auto& delta = bainv2_[v];
+        for (std::size_t j = 0; j < P.size(); ++j) {
+            if (skip_[j]) continue;
+            u32 p = P[j];
+            if (minus) {
+                root1_[j] += delta[j]; if (root1_[j] >= p) root1_[j] -= p;
+                root2_[j] += delta[j]; if (root2_[j] >= p) root2_[j] -= p;
+            } else {
+                root1_[j] += p - delta[j]; if (root1_[j] >= p) root1_[j] -= p;
+                root2_[j] += p - delta[j]; if (root2_[j] >= p) root2_[j] -= p;
+            }
+        }
+    }
+
+    // Просеивание интервала [-M, M) поблочно: для каждого простого хранится
+    // следующая позиция, так что крупные p пропускают блоки без попаданий
+    void sieve_polynomial() {
+        const auto& P = fb_.primes;
+        const auto& L = fb_.logs;
+        const std::size_t F = P.size();
+        for (std::size_t j = 0; j < F; ++j) {
+            next1_[j] = root1_[j];
+            next2_[j] = root2_[j];
+        }
+        for (std::size_t start = 0; start < interval_ && !store_.done(); start += kBlockSize) {
+            const u32 end = static_cast<u32>(start + kBlockSize);
+            u8* sieve = sieve_.data();
+            std::memset(sieve_.data(), init_, kBlockSize);
+            for (std::size_t j = fb_.sieve_start; j < F; ++j) {
+                if (skip_[j]) continue;
+                const u32 p = P[j];
+                const u8 logp = L[j];
+                u32 r1 = next1_[j], r2 = next2_[j];
+                for (; r1 < end; r1 += p) sieve[r1 - start] += logp;
+                for (; r2 < end; r2 += p) sieve[r2 - start] += logp;
+                next1_[j] = r1;
+                next2_[j] = r2;
+            }
+            scan_block(sieve_.data(), kBlockSize, candidates_);
+            for (u32 offset : candidates_) {
+                check_candidate(static_cast<u32>(start) + offset);
+            }
+        }
+    }
+
+    // Пробное деление Q(x)/a для кандидата; делимость на просеиваемые простые
+    // определяется по корням без деления многоточного числа
+    void check_candidate(u32 pos) {
+        const auto& P = fb_.primes;
+        BigInt x = BigInt(pos) - BigInt(half_);
+        BigInt y = a_ * x + b_;
+        BigInt v = (a_ * x + 2 * b_) * x + c_;
+
+        Relation rel;
+        if (v < 0) {
+            rel.factors.push_back(0);
+            v = -v;
+        }
+        if (v == 0) return;
+        for (std::size_t j : a_idx_) rel.factors.push_back(static_cast<u32>(j + 1));
+
+        for (std::size_t j = 0; j < P.size(); ++j) {
+            const u32 p = P[j];
+            if (!skip_[j]) {
+                u32 r = pos % p;
+                if (r != root1_[j] && r != root2_[j]) continue;
+            }
+            while (v % p == 0) {
+                v /= p;
+                rel.factors.push_back(static_cast<u32>(j + 1));
+            }
+        }
+
+        rel.y = y;
+        if (v == 1) {
+            store_.add_full(std::move(rel));
+        } else if (v < large_bound_) {
+            store_.add_partial(static_cast<u64>(v), std::move(rel));
+        }
+    }
+
+    const FactorBase& fb_;
+    RelationStore& store_;
+    std::mutex& a_mutex_;
+    std::unordered_set<u64>& used_a_;
+    std::mt19937_64 rng_;
+    std::size_t interval_, half_;
+    u64 large_bound_ = 0;
+    u8 init_ = 0;
+    double log_target_ = 0;
+
+    BigInt a_, b_, c_;
+    std::vector<std::size_t> a_idx_;
+    std::vector<BigInt> B_;
+    std::vector<std::vector<u32>> bainv2_;
+    std::vector<u32> ainv_, root1_, root2_, next1_, next2_;
+    std::vector<bool> skip_;
+    std::vector<u8> sieve_;
+    std::vector<u32> candidates_;
+};
+
+// Линейная алгебра над GF(2). Сначала структурная чистка — итеративно удаляются
+// соотношения со столбцами веса 1 (они не могут войти ни в одну зависимость),
+// затем гауссово исключение на упакованных строках с присоединённой единичной матрицей.
+// Возвращает наборы индексов соотношений, произведение которых — полный квадрат.
+inline std::vector<std::vector<std::size_t>> find_dependencies(const std::vector<Relation>& rels, std::size_t columns) {
+    std::vector<std::vector<u32>> odd(rels.size());
+    for (std::size_t i = 0; i < rels.size(); ++i) {
+        std::vector<u32> f = rels[i].factors;
+        std::sort(f.begin(), f.end());
+        for (std::size_t k = 0; k < f.size();) {
+            std::size_t e = k;
+            while (e < f.size() && f[e] == f[k]) ++e;
+            if ((e - k) % 2) odd[i].push_back(f[k]);
+            k = e;
+        }
+    }
+
+    std::vector<bool> alive(rels.size(), true);
+    for (bool changed = true; changed;) {
+        changed = false;
+        std::vector<u32> weight(columns, 0);
+        for (std::size_t i = 0; i < rels.size(); ++i) {
+            if (!alive[i]) continue;
+            for (u32 c : odd[i]) ++weight[c];
+        }
+        for (std::size_t i = 0; i < rels.size(); ++i) {
+            if (!alive[i]) continue;
+            for (u32 c : odd[i]) {
+                if (weight[c] == 1) {
+                    alive[i] = false;
+                    changed = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    std::vector<std::size_t> rows;
+    for (std::size_t i = 0; i < rels.size(); ++i) {
+        if (alive[i]) rows.push_back(i);
+    }
+    const std::size_t R = rows.size();
+    const std::size_t words = (columns + R + 63) / 64;
+    std::vector<std::vector<u64>> m(R, std::vector<u64>(words, 0));
+    for (std::size_t r = 0; r < R; ++r) {
+        for (u32 c : odd[rows[r]]) m[r][c / 64] ^= u64(1) << (c % 64);
+        std::size_t id = columns + r;
+        m[r][id / 64] |= u64(1) << (id % 64);
+    }
+
+    std::size_t rank = 0;
+    for (std::size_t c = 0; c < columns && rank < R; ++c) {
+        const std::size_t w = c / 64;
+        const u64 bit = u64(1) << (c % 64);
+        std::size_t pivot = rank;
+        while (pivot < R && !(m[pivot][w] & bit)) ++pivot;
+        if (pivot == R) continue;
+        std::swap(m[pivot], m[rank]);
+        for (std::size_t r = rank + 1; r < R; ++r) {
+            if (!(m[r][w] & bit)) continue;
+            for (std::size_t k = w; k < words; ++k) m[r][k] ^= m[rank][k];
+        }
+        ++rank;
+    }
+
+    std::vector<std::vector<std::size_t>> deps;
+    for (std::size_t r = rank; r < R; ++r) {
+        std::vector<std::size_t> dep;
+        for (std::size_t k = 0; k < R; ++k) {
+            std::size_t id = columns + k;
+            if (m[r][id / 64] & (u64(1) << (id % 64))) dep.push_back(rows[k]);
+        }
+        if (!dep.empty()) deps.push_back(std::move(dep));
+    }
+    return deps;
+}
+
+// Поиск делителя n методом SIQS
+inline std::optional<BigInt> find_factor(const BigInt& n, const Params& params = {}) {
+    const unsigned bits = static_cast<unsigned>(boost::multiprecision::msb(n)) + 1;
+    if (bits < 40) {
+        throw std::invalid_argument("SIQS requires n of at least 40 bits, use trial division");
+    }
+    const SizeParams& sp = size_params(bits);
+    const std::size_t fb_size = params.factor_base_size ? params.factor_base_size : sp.fb_size;
+    const unsigned blocks = params.sieve_blocks ? params.sieve_blocks : sp.blocks;
+
+    FactorBase fb(n, fb_size);
+    // Малый множитель базы сам может оказаться делителем n
+    for (u32 p : fb.primes) {
+        if (n % p == 0 && n != p) return BigInt(p);
+    }
+
+    const std::size_t columns = fb.primes.size() + 1;
+    RelationStore store(n, columns + kExtraRelations);
+    std::mutex a_mutex;
+    std::unordered_set<u64> used_a;
+
+    unsigned threads = params.threads ? params.threads : std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < threads; ++t) {
+        pool.emplace_back([&, t] {
+            SieveWorker(fb, sp, blocks, params.seed + t, store, a_mutex, used_a).run();
+        });
+    }
+    for (auto& t : pool) t.join();
+
+    const std::vector<Relation> rels = store.take();
+    for (const auto& dep : find_dependencies(rels, columns)) {
+        // X = prod y, Y = sqrt(prod Q) = prod p^(e/2) * prod L  (mod n)
+        std::vector<u32> exponent(columns, 0);
+        BigInt X = 1, Y = 1;
+        for (std::size_t i : dep) {
+            X = X * rels[i].y % n;
+            Y = Y * rels[i].large % n;
+            for (u32 c : rels[i].factors) ++exponent[c];
+        }
+        for (std::size_t c = 1; c < columns; ++c) {
+            if (exponent[c] >= 2) {
+                BigInt power = boost::multiprecision::powm(BigInt(fb.primes[c - 1]), BigInt(exponent[c] / 2), n);
+                Y = Y * power % n;
+            }
+        }
+        if (X < 0) X += n;
+        BigInt g = boost::multiprecision::gcd(X - Y, n);
+        if (g > 1 && g < n) return g;
+    }
+    return std::nullopt;
+}
+
+} // namespace QS
+
+// Разложение n = p * q (p <= q) и метод, которым найден делитель
+struct Factorization {
+    BigInt p, q;
+    const char* method;
+};
+
+// Факторизация n = p * q: пробное деление на малые простые, затем ECM
+inline Factorization factorize(const BigInt& n, const ECM::Params& params = {}) {
+    for (u64 p : primes_up_to(1000)) {
+        if (n % p == 0 && n != p) return {BigInt(p), n / p, "trial division"};
+    }
+    if (boost::multiprecision::miller_rabin_test(n, 25)) {
+        throw std::runtime_error("n is prime, nothing to factorize");
+    }
+    auto factor = ECM::find_factor(n, params);
+    if (!factor) {
+        throw std::runtime_error("ECM failed to factorize n, increase B1 or the number of curves");
+    }
+    BigInt p = *factor, q = n / p;
+    if (p > q) std::swap(p, q);
+    return {p, q, "ECM"};
+}
+
+// Факторизация n = p * q квадратичным решетом — для модулей с множителями одного размера
+inline Factorization factorize_siqs(const BigInt& n, const QS::Params& params = {}) {
+    if (boost::multiprecision::miller_rabin_test(n, 25)) {
+        throw std::runtime_error("n is prime, nothing to factorize");
+    }
+    auto factor = QS::find_factor(n, params);
+    if (!factor) {
+        throw std::runtime_error("SIQS found no proper factor, retry with another seed");
+    }
+    BigInt p = *factor, q = n / p;
+    if (p > q) std::swap(p, q);
+    return {p, q, "SIQS"};
+}
+
+enum class Method { ECM, SIQS };
+
+// Атака на RSA с модулем среднего размера
+inline BigInt attack(const BigInt& e, const BigInt& n, const BigInt& ciphertext, Method method = Method::ECM) {
+    auto [p, q, found_by] = method == Method::ECM ? factorize(n) : factorize_siqs(n);
+    std::cout << "Factorization (" << found_by << "): n = " << n << " = " << p << " * " << q << '\n';
+
+    BigInt phi = (p - 1) * (q - 1);
+    std::cout << "phi(n) = " << phi << '\n';
+
+    auto d_opt = modular_inverse(e, phi);
+    if (!d_opt) {
+        throw std::runtime_error("No modular inverse for e and phi(n)");
+    }
+    BigInt d = *d_opt;
+    std::cout << "Private exponent: d = " << d << '\n';
+
+    BigInt plaintext = boost::multiprecision::powm(ciphertext, d, n);
+    std::cout << "Decrypted (number): " << plaintext << '\n';
+    return plaintext;
+}
+
+// Число -> строка байтов (старший байт первым)
+inline std::string to_text(BigInt m) {
+    std::string text;
+    for (; m > 0; m >>= 8) {
+        text.insert(text.begin(), static_cast<char>(static_cast<unsigned>(m & 0xFF)));
+    }
+    return text;
+}
+
 } // namespace RSAAttack
 
 int main() {
@@ -91,7 +1015,7 @@ int main() {
     std::cout << "Ciphertext: c = " << c << "\n\n";
 
     try {
-        u64 m = RSAAttack::attack(e, n, c);
+        RSAAttack::u64 m = RSAAttack::attack(e, n, c);
         if (m < 256) {
             char ch = static_cast<char>(m);
             std::cout << "Decrypted (char): '" << ch << "'\n";
@@ -101,5 +1025,41 @@ int main() {
         return EXIT_FAILURE;
     }
 
+    std::cout << "\n=== RSA Mid-size Modulus Attack (ECM) ===\n";
+
+    // Модуль 112 бит с 40-битным множителем — вне досягаемости пробного деления
+    const RSAAttack::BigInt big_e = 65537;
+    const RSAAttack::BigInt big_n("2747988588937020987906272786331377");
+    const RSAAttack::BigInt big_c("1007502417138563788745969066871709");
+
+    std::cout << "Public key: e = " << big_e << ", n = " << big_n << "\n";
+    std::cout << "Ciphertext: c = " << big_c << "\n\n";
+
+    try {
+        RSAAttack::BigInt m = RSAAttack::attack(big_e, big_n, big_c);
+        std::cout << "Decrypted (text): \"" << RSAAttack::to_text(m) << "\"\n";
+    } catch (const std::exception& ex) {
+        std::cerr << "Error: " << ex.what() << "\n";
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "\n=== RSA Balanced Modulus Attack (SIQS) ===\n";
+
+    // 127-битный модуль из двух 64-битных простых. Для ECM это худший случай (его время растёт
+    // с меньшим множителем), а для SIQS — обычный: время решета зависит только от размера n
+    const RSAAttack::BigInt qs_n("122875812242829647580865363550810263867");
+    const RSAAttack::BigInt qs_c("102842282581201711054433069879120097595");
+
+    std::cout << "Public key: e = " << big_e << ", n = " << qs_n << "\n";
+    std::cout << "Ciphertext: c = " << qs_c << "\n\n";
+
+    try {
+        RSAAttack::BigInt m = RSAAttack::attack(big_e, qs_n, qs_c, RSAAttack::Method::SIQS);
+        std::cout << "Decrypted (text): \"" << RSAAttack::to_text(m) << "\"\n";
+    } catch (const std::exception& ex) {
+        std::cerr << "Error: " << ex.what() << "\n";
+        return EXIT_FAILURE;
+    }
+
     return EXIT_SUCCESS;
 }
@@ -0,0 +1,291 @@
+// rsa_cipher.cpp
+#include "rsa_cipher.h"
+#include "../common/instrumentation.h"
+
+#include <boost/multiprecision/miller_rabin.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <random>
+#include <fstream>
+#include <system_error>
+#include <stdexcept>
+
+using namespace boost::multiprecision;
+using namespace std;
+
+// Размер порции чтения при обработке файла (округляется вниз до целого числа блоков)
+constexpr size_t kChunkBytes = 1 << 16;
+
+// Генератор случайных чисел (глобально)
+mt19937_64 gen(random_device{}());
+std::uniform_int_distribution<uint64_t> dist64(0, UINT64_MAX);
+
+void seed_random(uint64_t seed) {
+    gen.seed(seed);
+}
+
+// Быстрое возведение в степень по модулю
+BigInt mod_pow(BigInt base, BigInt exp, const BigInt& mod) {
+    BigInt result = 1;
+    base %= mod;
+    while (exp > 0) {
+        if (exp % 2 == 1)
+            result = (result * base) % mod;
+        exp >>= 1;
+        base = (base * base) % mod;
+    }
+    return result;
+}
+
+// Тест Ферма на простоту
+bool is_prime(const BigInt& n, int k) {
+    if (n <= 1) return false;
+    if (n == 2) return true;
+    if (n % 2 == 0) return false;
+
+    for (int i = 0; i < k; ++i) {
+        BigInt a = 2 + dist64(gen) % (n - 3);
+        if (mod_pow(a, n - 1, n) != 1)
+            return false;
+    }
+    return true;
+}
+
+// Генерация случайного BigInt заданной битовой длины
+BigInt generate_random_bits(int bits) {
+    BigInt result = 0;
+    for (int i = 0; i < bits; ++i) {
+        if (dist64(gen) & 1)
+            result |= (BigInt(1) << i);
+    }
+    result |= (BigInt(1) << (bits - 1));  // устанавливаем старший бит
+    return result;
+}
+
+// Генерация простого числа
+BigInt generate_prime(int bits) {
+    while (true) {
+        BigInt candidate = generate_random_bits(bits);
+        if (candidate % 2 == 0)
+            ++candidate;
+        if (is_prime(candidate))
+            return candidate;
+    }
+}
+
+// Расширенный алгоритм Евклида
+BigInt extended_gcd(BigInt a, BigInt b, BigInt& x, BigInt& y) {
+    if (a == 0) {
+        x = 0; y = 1;
+        return b;
+    }
+    BigInt x1, y1;
+    BigInt gcd = extended_gcd(b % a, a, x1, y1);
+    x = y1 - (b / a) * x1;
+    y = x1;
+    return gcd;
+}
+
+// Обратное по модулю
+BigInt mod_inverse(const BigInt& e, const BigInt& phi) {
+    BigInt x, y;
+    BigInt g = extended_gcd(e, phi, x, y);
+    if (g != 1)
+        throw runtime_error("Обратный элемент не существует");
+    return (x % phi + phi) % phi;
+}
+
+// Генерация ключей RSA
+pair<pair<BigInt, BigInt>, pair<BigInt, BigInt>> generate_keypair(int bits) {
+    INSTRUMENT_SCOPE("keygen");
+    BigInt p = generate_prime(bits / 2);
+    BigInt q = generate_prime(bits / 2);
+    while (p == q)
+        q = generate_prime(bits / 2);
+
+    BigInt n = p * q;
+    BigInt phi = (p - 1) * (q - 1);
+
+    BigInt e = 65537;
+    if (gcd(e, phi) != 1) {
+        for (BigInt i = 3; i < phi; i += 2) {
+            if (gcd(i, phi) == 1) {
+                e = i;
+                break;
+            }
+        }
+    }
+
+    BigInt d = mod_inverse(e, phi);
+    return {{e, n}, {d, n}};
+}
+
+// Добавление паддинга (PKCS#7)
+vector<uint8_t> add_padding(const vector<uint8_t>& data, size_t block_size) {
+    size_t pad_len = block_size - (data.size() % block_size);
+    vector<uint8_t> padded = data;
+    padded.insert(padded.end(), pad_len, static_cast<uint8_t>(pad_len));
+    return padded;
+}
+
+// Удаление паддинга
+vector<uint8_t> remove_padding(const vector<uint8_t>& data) {
+    if (data.empty()) return data;
+    uint8_t pad_len = data.back();
+    if (pad_len == 0 || pad_len > data.size())
+        throw runtime_error("Некорректный паддинг");
+    for (size_t i = data.size() - pad_len; i < data.size(); ++i) {
+        if (data[i] != pad_len)
+            throw runtime_error("Некорректный паддинг");
+    }
+    return vector<uint8_t>(data.begin(), data.end() - pad_len);
+}
+
+// Шифрование одного блока
+BigInt encrypt_block(BigInt m, const BigInt& e, const BigInt& n) {
+    if (m >= n) throw runtime_error("Блок сообщения больше модуля n");
+    INSTRUMENT_SCOPE("exponentiation");
+    return mod_pow(m, e, n);
+}
+
+// Расшифрование одного блока
+BigInt decrypt_block(BigInt c, const BigInt& d, const BigInt& n) {
+    if (c >= n) throw runtime_error("Блок шифра больше модуля n");
+    INSTRUMENT_SCOPE("exponentiation");
+    return mod_pow(c, d, n);
+}
+
+// Блок — число, записанное width байтами старшим байтом вперёд
+static BigInt load_block(const uint8_t* data, size_t width) {
+    BigInt x;
+    import_bits(x, data, data + width);
+    return x;
+}
+
+static void store_block(const BigInt& x, uint8_t* out, size_t width) {
+    size_t len = x == 0 ? 0 : msb(x) / 8 + 1;
+    if (len > width)
+        throw runtime_error("Блок не помещается в выходной блок");
+    fill(out, out + width - len, 0);
+    if (len) export_bits(x, out + width - len, 8);
+}
+
+// Шифрование или расшифрование потока порциями из целого числа блоков
+static void process_stream(istream& in, ostream& out, const BigInt& exp, const BigInt& n, bool encrypt) {
+    size_t block_size = msb(n) / 8;
+    size_t cipher_size = (msb(n) + 7) / 8;
+
+    const size_t in_size = encrypt ? block_size : cipher_size;
+    const size_t out_size = encrypt ? cipher_size : block_size;
+    const size_t chunk_blocks = max<size_t>(1, kChunkBytes / in_size);
+
+    vector<uint8_t> in_buf(chunk_blocks * in_size);
+    vector<uint8_t> out_buf(chunk_blocks * out_size);
+
+    auto convert = [&](const uint8_t* src, uint8_t* dst) {
+        BigInt x = load_block(src, in_size);
+        store_block(encrypt ? encrypt_block(x, exp, n) : decrypt_block(x, exp, n), dst, out_size);
+    };
+    auto write = [&](const uint8_t* data, size_t size) {
+        INSTRUMENT_SCOPE("write");
+        out.write(reinterpret_cast<const char*>(data), size);
+    };
+
+    // При расшифровании последний блок порции придерживается до следующей порции:
+    // дополнение снимается только с последнего блока файла
+    bool have_held = false;
+    vector<uint8_t> held(block_size);
+    size_t tail = 0;
+    while (true) {
+        {
+            INSTRUMENT_SCOPE("read");
+            in.read(reinterpret_cast<char*>(in_buf.data()), in_buf.size());
+        }
+        size_t got = in.gcount();
+        INSTRUMENT_COUNT("bytes_in", got);
+        size_t blocks = got / in_size;
+        INSTRUMENT_COUNT("blocks", blocks);
+
+        for (size_t i = 0; i < blocks; ++i)
+            convert(&in_buf[i * in_size], &out_buf[i * out_size]);
+
+        if (encrypt || blocks == 0) {
+            write(out_buf.data(), blocks * out_size);
+        } else {
+            if (have_held) write(held.data(), block_size);
+            write(out_buf.data(), (blocks - 1) * block_size);
+            copy_n(&out_buf[(blocks - 1) * block_size], block_size, held.begin());
+            have_held = true;
+        }
+
+        if (got < in_buf.size()) {
+            tail = got - blocks * in_size;
+            copy_n(&in_buf[blocks * in_size], tail, in_buf.begin());
+            break;
+        }
+    }
+    if (in.bad())
+        throw runtime_error("Ошибка чтения файла");
+
+    if (encrypt) {
+        vector<uint8_t> last;
+        {
+            INSTRUMENT_SCOPE("pad");
+            last = add_padding(vector<uint8_t>(in_buf.begin(), in_buf.begin() + tail), block_size);
+        }
+        INSTRUMENT_COUNT("blocks", 1);
+        convert(last.data(), out_buf.data());
+        write(out_buf.data(), cipher_size);
+    } else {
+        if (tail != 0)
+            throw runtime_error("Некратный размер шифртекста");
+        if (have_held) {
+            vector<uint8_t> last;
+            {
+                INSTRUMENT_SCOPE("unpad");
+                last = remove_padding(held);
+            }
+            write(last.data(), last.size());
+        }
+    }
+
+    INSTRUMENT_SCOPE("write");
+    out.flush();
+    if (!out)
+        throw runtime_error("Ошибка записи файла");
+}
+
+// Обработка файла (encrypt/decrypt) потоком: файл читается и пишется порциями из целого
+// числа блоков, поэтому расход памяти не зависит от размера файла
+void process_file(const string& input_file, const string& output_file, const pair<BigInt, BigInt>& key, const string& mode) {
+    const BigInt& n = key.second;
+    if (msb(n) / 8 == 0)
+        throw runtime_error("Модуль n слишком мал");
+    const bool encrypt = mode == "encrypt";
+
+    // Длина шифртекста проверяется до расшифрования первого блока; для входа, размер которого
+    // заранее неизвестен (канал), остаётся проверка в конце потока
+    if (!encrypt) {
+        size_t cipher_size = (msb(n) + 7) / 8;
+        error_code ec;
+        auto size = filesystem::file_size(input_file, ec);
+        if (!ec && size % cipher_size != 0)
+            throw runtime_error("Некратный размер шифртекста");
+    }
+
+    ifstream in(input_file, ios::binary);
+    ofstream out(output_file, ios::binary);
+    if (!in || !out)
+        throw runtime_error("Не удалось открыть входной или выходной файл");
+
+    try {
+        process_stream(in, out, key.first, n, encrypt);
+    } catch (...) {
+        // Ошибка может обнаружиться после записи части блоков (например, неверное дополнение
+        // последнего блока) — неполный результат не оставляем
+        out.close();
+        remove(output_file.c_str());
+        throw;
+    }
+}
@@ -0,0 +1,43 @@
+// rsa_cipher.h
+#ifndef RSA_CIPHER_H
+#define RSA_CIPHER_H
+
+#include <boost/multiprecision/cpp_int.hpp>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+using BigInt = boost::multiprecision::cpp_int;
+
+// Ключ — пара (показатель, модуль n)
+using RSAKey = std::pair<BigInt, BigInt>;
+
+// Переинициализация генератора, из которого берутся простые числа ключей
+// (фиксированное зерно делает генерацию воспроизводимой для тестов и замеров)
+void seed_random(uint64_t seed);
+
+BigInt mod_pow(BigInt base, BigInt exp, const BigInt& mod);
+bool is_prime(const BigInt& n, int k = 5);
+BigInt generate_random_bits(int bits);
+BigInt generate_prime(int bits);
+BigInt extended_gcd(BigInt a, BigInt b, BigInt& x, BigInt& y);
+BigInt mod_inverse(const BigInt& e, const BigInt& phi);
+
+// {{e, n}, {d, n}}
+std::pair<RSAKey, RSAKey> generate_keypair(int bits);
+
+std::vector<uint8_t> add_padding(const std::vector<uint8_t>& data, size_t block_size);
+std::vector<uint8_t> remove_padding(const std::vector<uint8_t>& data);
+
+BigInt encrypt_block(BigInt m, const BigInt& e, const BigInt& n);
+BigInt decrypt_block(BigInt c, const BigInt& d, const BigInt& n);
+
+// mode: "encrypt" или "decrypt". Файл обрабатывается потоком порциями из целого числа блоков
+// (block_size байт открытого текста, cipher_size байт шифртекста), дополнение — только в последнем
+// блоке; расход памяти не зависит от размера файла. Шифртекст некратной длины отвергается до
+// открытия выходного файла; при ошибке после начала записи неполный выходной файл удаляется
+void process_file(const std::string& input_file, const std::string& output_file, const RSAKey& key,
+                  const std::string& mode);
+
+#endif // RSA_CIPHER_H
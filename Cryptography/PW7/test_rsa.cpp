@@ -0,0 +1,183 @@
+#include "rsa_cipher.h"
+#include "batch_rsa.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <optional>
+#include <string>
+
+void testModularArithmetic() {
+    assert(mod_pow(4, 13, 497) == 445);
+    assert(mod_pow(2, 0, 7) == 1);
+
+    BigInt inv = mod_inverse(17, 3120);
+    assert(inv == 2753);
+    assert(is_prime(BigInt(65537)));
+    assert(!is_prime(BigInt(65535)));
+
+    std::cout << "[PASS] Modular arithmetic test" << std::endl;
+}
+
+void testBlockEncryptionDecryption() {
+    seed_random(1);
+    auto [pub, priv] = generate_keypair(256);
+    assert(pub.second == priv.second);
+
+    BigInt m = 0x48656c6c6f;   // "Hello"
+    BigInt c = encrypt_block(m, pub.first, pub.second);
+    assert(c != m);
+    assert(decrypt_block(c, priv.first, priv.second) == m);
+
+    std::cout << "[PASS] Block encryption/decryption test" << std::endl;
+}
+
+void testPadding() {
+    std::vector<uint8_t> data = { 'T', 'E', 'S', 'T' };
+
+    auto padded = add_padding(data, 8);
+    assert(padded.size() == 8);
+    for (size_t i = 4; i < 8; ++i) assert(padded[i] == 4);
+    assert(remove_padding(padded) == data);
+
+    std::cout << "[PASS] Padding/unpadding test" << std::endl;
+}
+
+void testFileRoundTrip() {
+    seed_random(2);
+    auto [pub, priv] = generate_keypair(256);
+    size_t block_size = msb(pub.second) / 8;
+
+    const char* plain = "test_rsa.plain";
+    const char* cipher = "test_rsa.enc";
+    const char* decrypted = "test_rsa.dec";
+    // Пустой файл, ровно один блок (дополнение целым блоком) и файлы длиннее одной порции чтения
+    for (size_t size : {size_t(0), block_size, size_t(1000), size_t(70000), 70000 / block_size * block_size}) {
+        std::vector<uint8_t> data(size);
+        for (size_t i = 0; i < data.size(); ++i) data[i] = static_cast<uint8_t>(i * 7 + 3);
+        std::ofstream(plain, std::ios::binary).write(reinterpret_cast<const char*>(data.data()), data.size());
+
+        process_file(plain, cipher, pub, "encrypt");
+        process_file(cipher, decrypted, priv, "decrypt");
+
+        std::ifstream in(decrypted, std::ios::binary);
+        std::vector<uint8_t> result((std::istreambuf_iterator<char>(in)), {});
+        assert(result == data);
+    }
+
+    std::remove(plain);
+    std::remove(cipher);
+    std::remove(decrypted);
+    std::cout << "[PASS] File encryption/decryption test" << std::endl;
+}
+
+void testFileErrors() {
+    seed_random(5);
+    auto [pub, priv] = generate_keypair(256);
+    size_t cipher_size = (msb(pub.second) + 7) / 8;
+
+    const char* plain = "test_rsa_err.plain";
+    const char* cipher = "test_rsa_err.enc";
+    const char* decrypted = "test_rsa_err.dec";
+    std::vector<char> data(70000, 'x');
+    std::ofstream(plain, std::ios::binary).write(data.data(), data.size());
+    process_file(plain, cipher, pub, "encrypt");
+
+    std::ifstream in(cipher, std::ios::binary);
+    std::vector<char> encrypted((std::istreambuf_iterator<char>(in)), {});
+    in.close();
+
+    // Возвращает содержимое выходного файла после неудачного расшифрования (nullopt — файла нет)
+    auto decrypt_fails = [&](const std::vector<char>& ciphertext) -> std::optional<std::string> {
+        std::ofstream(cipher, std::ios::binary).write(ciphertext.data(), ciphertext.size());
+        std::ofstream(decrypted) << "previous contents";
+        bool rejected = false;
+        try {
+            process_file(cipher, decrypted, priv, "decrypt");
+        } catch (const std::runtime_error&) {
+            rejected = true;
+        }
+        assert(rejected);
+        std::ifstream out(decrypted);
+        if (!out) return std::nullopt;
+        return std::string((std::istreambuf_iterator<char>(out)), {});
+    };
+
+    // Некратная длина отвергается до расшифрования: выходной файл не тронут
+    assert(decrypt_fails(std::vector<char>(encrypted.begin(), encrypted.end() - 1)) == "previous contents");
+    // Неверное дополнение обнаруживается только на последнем блоке, после записи остальных:
+    // неполный результат удалён
+    auto bad_padding = encrypted;
+    std::fill(bad_padding.end() - cipher_size, bad_padding.end(), 0);
+    assert(!decrypt_fails(bad_padding));
+
+    std::remove(decrypted);
+    std::remove(plain);
+    std::remove(cipher);
+    std::cout << "[PASS] File error handling test" << std::endl;
+}
+
+void testBatchDecrypt() {
+    seed_random(3);
+    auto key = generate_batch_keypair(256, 5);
+    assert(key.exponents.size() == 5);
+
+    // Пакет в произвольном порядке ключей, в том числе из одного запроса
+    for (std::vector<size_t> order : {std::vector<size_t>{0, 1, 2, 3, 4}, {4, 2, 0}, {3}}) {
+        std::vector<BatchRequest> requests;
+        std::vector<BigInt> messages;
+        for (size_t index : order) {
+            BigInt m = generate_random_bits(200);
+            auto [e, n] = key.public_key(index);
+            requests.push_back({index, encrypt_block(m, e, n)});
+            messages.push_back(m);
+        }
+        assert(batch_decrypt(key, requests) == messages);
+    }
+
+    bool rejected = false;
+    try {
+        batch_decrypt(key, {{1, 2}, {1, 3}});
+    } catch (const std::runtime_error&) {
+        rejected = true;
+    }
+    assert(rejected);
+
+    std::cout << "[PASS] Batch decryption test" << std::endl;
+}
+
+void testBatchScheduler() {
+    seed_random(4);
+    auto key = generate_batch_keypair(256, 4);
+    std::vector<BigInt> messages;
+    std::vector<std::future<BigInt>> results;
+    {
+        BatchScheduler scheduler(key, std::chrono::milliseconds(5));
+        // Десять запросов под четырьмя ключами: повторы уходят в следующие пакеты
+        for (size_t i = 0; i < 10; ++i) {
+            BigInt m = generate_random_bits(200);
+            auto [e, n] = key.public_key(i % 4);
+            messages.push_back(m);
+            results.push_back(scheduler.submit(i % 4, encrypt_block(m, e, n)));
+        }
+        for (size_t i = 0; i < results.size(); ++i) assert(results[i].get() == messages[i]);
+        assert(scheduler.requests() == 10);
+        assert(scheduler.batches() >= 3);
+    }
+
+    std::cout << "[PASS] Batch scheduler test" << std::endl;
+}
+
+int main() {
+    testModularArithmetic();
+    testBlockEncryptionDecryption();
+    testPadding();
+    testFileRoundTrip();
+    testFileErrors();
+    testBatchDecrypt();
+    testBatchScheduler();
+    std::cout << "All tests passed.\n";
+    return 0;
+}
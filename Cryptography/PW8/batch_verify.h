@@ -0,0 +1,134 @@
+// batch_verify.h
+#ifndef BATCH_VERIFY_H
+#define BATCH_VERIFY_H
+
+#include "gost_signature.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Пакетная проверка подписей по манифесту: общая часть утилиты gost_sign и тестов.
+
+// Файл подписи: r и s в шестнадцатеричном виде через пробел
+template <size_t N>
+std::pair<UInt<N>, UInt<N>> read_signature(const std::string& path) {
+    if (!std::filesystem::exists(path)) {
+        throw std::runtime_error("Signature file not found: " + path);
+    }
+    std::ifstream sig_file(path);
+    std::string r, s;
+    if (!(sig_file >> r >> s)) throw std::runtime_error("Malformed signature file: " + path);
+    return {UInt<N>::from_hex(r), UInt<N>::from_hex(s)};
+}
+
+// Строка манифеста пакетной проверки: <файл сообщения> <файл подписи> <Qx> <Qy>
+template <size_t N>
+struct BatchEntry {
+    std::string message_file, signature_file;
+    UInt<N> x, y;
+    std::string error;   // непустая — строку не удалось разобрать
+};
+
+template <size_t N>
+std::vector<BatchEntry<N>> read_manifest(const std::string& path) {
+    if (!std::filesystem::exists(path)) {
+        throw std::runtime_error("Manifest not found: " + path);
+    }
+    std::ifstream in(path);
+    std::vector<BatchEntry<N>> entries;
+    std::string line;
+    for (size_t line_no = 1; std::getline(in, line); ++line_no) {
+        if (line.empty() || line[0] == '#') continue;
+        std::istringstream fields(line);
+        BatchEntry<N> entry;
+        std::string x, y;
+        if (!(fields >> entry.message_file >> entry.signature_file >> x >> y)) {
+            entry.message_file = entry.message_file.empty() ? "line " + std::to_string(line_no) : entry.message_file;
+            entry.error = "malformed manifest line " + std::to_string(line_no);
+        } else {
+            try {
+                entry.x = UInt<N>::from_hex(x);
+                entry.y = UInt<N>::from_hex(y);
+            } catch (const std::exception& e) {
+                entry.error = e.what();
+            }
+        }
+        entries.push_back(std::move(entry));
+    }
+    return entries;
+}
+
+// task(i) для всех i из [0, count) на пуле потоков; потоки разбирают индексы через общий счётчик.
+// task не должна бросать исключений.
+template <class Task>
+void parallel_for(size_t count, unsigned threads, Task task) {
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = static_cast<unsigned>(std::min<size_t>(threads, count));
+    std::atomic<size_t> next{0};
+    auto worker = [&] {
+        for (size_t i; (i = next.fetch_add(1)) < count;) task(i);
+    };
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < threads; ++t) pool.emplace_back(worker);
+    worker();
+    for (auto& t : pool) t.join();
+}
+
+enum class BatchStatus : char { Valid = 'V', Invalid = 'I', Error = 'E' };
+
+// Пакетная проверка по манифесту пулом потоков. Таблицы нечётных кратных открытых ключей
+// берутся из общего ограниченного кэша, поэтому повторяющийся ключ обрабатывается один раз.
+// В файл результатов пишется по строке на запись: OK / BAD / ERR и имя файла сообщения.
+// Возвращает число верных, неверных подписей и ошибок.
+template <size_t N>
+std::array<size_t, 3> batch_verify(const std::string& manifest_file, const std::string& result_file,
+                                   const EllipticCurve<N>& curve, unsigned threads = 0) {
+    auto entries = read_manifest<N>(manifest_file);
+    KeyCache<N> keys(curve);
+
+    std::vector<BatchStatus> status(entries.size(), BatchStatus::Error);
+    parallel_for(entries.size(), threads, [&](size_t i) {
+        auto& entry = entries[i];
+        if (!entry.error.empty()) return;
+        if (entry.x >= curve.field().modulus() || entry.y >= curve.field().modulus()) {
+            status[i] = BatchStatus::Invalid;
+            return;
+        }
+        try {
+            auto Q = curve.make_point(entry.x, entry.y);
+            auto h = hash_file<N>(entry.message_file);
+            auto signature = read_signature<N>(entry.signature_file);
+            status[i] = verify_signature(h, signature, curve, keys, Q) ? BatchStatus::Valid : BatchStatus::Invalid;
+        } catch (const std::exception& e) {
+            entry.error = e.what();
+        }
+    });
+
+    std::ofstream out(result_file);
+    if (!out) throw std::runtime_error("Cannot write results: " + result_file);
+    std::array<size_t, 3> counts{};
+    for (size_t i = 0; i < entries.size(); ++i) {
+        switch (status[i]) {
+        case BatchStatus::Valid:   out << "OK  " << entries[i].message_file << '\n'; ++counts[0]; break;
+        case BatchStatus::Invalid: out << "BAD " << entries[i].message_file << '\n'; ++counts[1]; break;
+        case BatchStatus::Error:
+            out << "ERR " << entries[i].message_file << ": " << entries[i].error << '\n';
+            ++counts[2];
+            break;
+        }
+    }
+    return counts;
+}
+
+#endif // BATCH_VERIFY_H
@@ -0,0 +1,81 @@
+// bench_gost.cpp
+// Замеры ГОСТ Р 34.10-2012: скалярное умножение произвольной точки и G (гребёнка),
+// подпись, проверка (разовая по JSF и с таблицами из кэша ключей). Отчёт в JSON
+// (см. common/benchmark.h).
+#include "gost_signature.h"
+#include "../common/benchmark.h"
+
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+// Входные данные перебираются по кругу, чтобы замер не сводился к одному удачному скаляру
+constexpr size_t kInputs = 256;
+
+template <size_t N>
+void bench_curve(const char* name, benchmark::Report& report, const benchmark::Options& options) {
+    EllipticCurve<N> curve(*find_curve_params(name));
+    FixedBaseComb<N> comb(curve);
+    KeyCache<N> keys(curve);
+    mt19937_64 gen(options.seed);
+
+    auto [d, Q] = generate_keypair(curve, comb, gen);
+    vector<UInt<N>> scalars(kInputs), hashes(kInputs);
+    vector<pair<UInt<N>, UInt<N>>> signatures(kInputs);
+    for (size_t i = 0; i < kInputs; ++i) {
+        scalars[i] = random_scalar(curve.order(), gen);
+        hashes[i] = random_scalar(curve.order(), gen);
+        signatures[i] = sign_hash(hashes[i], curve, comb, d, gen);
+    }
+
+    size_t iterations = options.quick ? 20 : 200;
+    double seconds = options.quick ? 0.0 : 0.5;
+    size_t i = 0;
+    auto next = [&] { return i++ % kInputs; };
+    auto add = [&](const string& op, const benchmark::Stats& stats) {
+        report.add(op, {{"curve", name}, {"bits", to_string(64 * N)}}, stats);
+    };
+
+    add("multiply_point", benchmark::measure([&] {
+        benchmark::do_not_optimize(curve.multiply_point(Q, scalars[next()]));
+    }, iterations, seconds));
+
+    add("multiply_point_fixed_base", benchmark::measure([&] {
+        benchmark::do_not_optimize(comb.multiply_point(scalars[next()]));
+    }, iterations, seconds));
+
+    add("sign", benchmark::measure([&] {
+        benchmark::do_not_optimize(sign_hash(hashes[next()], curve, comb, d, gen));
+    }, iterations, seconds));
+
+    add("verify", benchmark::measure([&] {
+        size_t j = next();
+        if (!verify_signature(hashes[j], signatures[j], curve, Q)) throw runtime_error("verify failed");
+    }, iterations, seconds));
+
+    add("verify_cached_key", benchmark::measure([&] {
+        size_t j = next();
+        if (!verify_signature(hashes[j], signatures[j], curve, keys, Q)) throw runtime_error("verify failed");
+    }, iterations, seconds));
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    try {
+        auto options = benchmark::parse_options(argc, argv);
+        benchmark::Report report("gost", options);
+        bench_curve<4>("tc26-256-A", report, options);
+        if (!options.quick) bench_curve<8>("tc26-512-A", report, options);
+        report.write();
+    } catch (const exception& e) {
+        cerr << "Ошибка: " << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
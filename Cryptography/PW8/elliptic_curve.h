@@ -0,0 +1,511 @@
+// elliptic_curve.h
+#ifndef ELLIPTIC_CURVE_H
+#define ELLIPTIC_CURVE_H
+
+#include "gost_field.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <optional>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Параметры кривой y^2 = x^3 + a*x + b над GF(p) с подгруппой простого порядка q
+// и образующей G = (x, y). Числа — шестнадцатеричные строки.
+struct CurveParams {
+    const char* name;
+    unsigned bits;   // разрядность поля: 256 или 512
+    const char* p;
+    const char* a;
+    const char* b;
+    const char* q;
+    const char* x;
+    const char* y;
+};
+
+// Наборы параметров ГОСТ Р 34.10-2012 (Р 1323565.1.024-2019, ТК 26)
+inline constexpr CurveParams kCurveParams[] = {
+    // Учебная кривая из лекций (p = 17), оставлена для отладки
+    {"toy-17", 256, "11", "2", "2", "13", "5", "1"},
+    // Контрольный пример 1 из ГОСТ Р 34.10-2012
+    {"test-256", 256,
+     "8000000000000000000000000000000000000000000000000000000000000431",
+     "7",
+     "5FBFF498AA938CE739B8E022FBAFEF40563F6E6A3472FC2A514C0CE9DAE23B7E",
+     "8000000000000000000000000000000150FE8A1892976154C59CFC193ACCF5B3",
+     "2",
+     "08E2A8A0E65147D4BD6316030E16D19C85C97F0A9CA267122B96ABBCEA7E8FC8"},
+    // id-tc26-gost-3410-2012-256-paramSetA
+    {"tc26-256-A", 256,
+     "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFD97",
+     "C2173F1513981673AF4892C23035A27CE25E2013BF95AA33B22C656F277E7335",
+     "295F9BAE7428ED9CCC20E7C359A9D41A22FCCD9108E17BF7BA9337A6F8AE9513",
+     "400000000000000000000000000000000FD8CDDFC87B6635C115AF556C360C67",
+     "91E38443A5E82C0D880923425712B2BB658B9196932E02C78B2582FE742DAA28",
+     "32879423AB1A0375895786C4BB46E9565FDE0B5344766740AF268ADB32322E5C"},
+    // id-tc26-gost-3410-2012-256-paramSetB (CryptoPro-A)
+    {"tc26-256-B", 256,
+     "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFD97",
+     "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFD94",
+     "A6",
+     "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF6C611070995AD10045841B09B761B893",
+     "1",
+     "8D91E471E0989CDA27DF505A453F2B7635294F2DDF23E3B122ACC99C9E9F1E14"},
+    // id-tc26-gost-3410-2012-256-paramSetC (CryptoPro-B)
+    {"tc26-256-C", 256,
+     "8000000000000000000000000000000000000000000000000000000000000C99",
+     "8000000000000000000000000000000000000000000000000000000000000C96",
+     "3E1AF419A269A5F866A7D3C25C3DF80AE979259373FF2B182F49D4CE7E1BBC8B",
+     "800000000000000000000000000000015F700CFFF1A624E5E497161BCC8A198F",
+     "1",
+     "3FA8124359F96680B83D1C3EB2C070E5C545C9858D03ECFB744BF8D717717EFC"},
+    // id-tc26-gost-3410-2012-256-paramSetD (CryptoPro-C)
+    {"tc26-256-D", 256,
+     "9B9F605F5A858107AB1EC85E6B41C8AACF846E86789051D37998F7B9022D759B",
+     "9B9F605F5A858107AB1EC85E6B41C8AACF846E86789051D37998F7B9022D7598",
+     "805A",
+     "9B9F605F5A858107AB1EC85E6B41C8AA582CA3511EDDFB74F02F3A6598980BB9",
+     "0",
+     "41ECE55743711A8C3CBF3783CD08C0EE4D4DC440D4641A8F366E550DFDB3BB67"},
+    // id-tc26-gost-3410-12-512-paramSetA
+    {"tc26-512-A", 512,
+     "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF"
+     "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFDC7",
+     "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF"
+     "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFDC4",
+     "E8C2505DEDFC86DDC1BD0B2B6667F1DA34B82574761CB0E879BD081CFD0B6265"
+     "EE3CB090F30D27614CB4574010DA90DD862EF9D4EBEE4761503190785A71C760",
+     "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF"
+     "27E69532F48D89116FF22B8D4E0560609B4B38ABFAD2B85DCACDB1411F10B275",
+     "3",
+     "7503CFE87A836AE3A61B8816E25450E6CE5E1C93ACF1ABC1778064FDCBEFA921"
+     "DF1626BE4FD036E93D75E6A50E3A41E98028FE5FC235F5B889A589CB5215F2A4"},
+    // id-tc26-gost-3410-12-512-paramSetB
+    {"tc26-512-B", 512,
+     "8000000000000000000000000000000000000000000000000000000000000000"
+     "000000000000000000000000000000000000000000000000000000000000006F",
+     "8000000000000000000000000000000000000000000000000000000000000000"
+     "000000000000000000000000000000000000000000000000000000000000006C",
+     "687D1B459DC841457E3E06CF6F5E2517B97C7D614AF138BCBF85DC806C4B289F"
+     "3E965D2DB1416D217F8B276FAD1AB69C50F78BEE1FA3106EFB8CCBC7C5140116",
+     "8000000000000000000000000000000000000000000000000000000000000001"
+     "49A1EC142565A545ACFDB77BD9D40CFA8B996712101BEA0EC6346C54374F25BD",
+     "2",
+     "1A8F7EDA389B094C2C071E3647A8940F3C123B697578C213BE6DD9E6C8EC7335"
+     "DCB228FD1EDF4A39152CBCAAF8C0398828041055F94CEEEC7E21340780FE41BD"},
+    // id-tc26-gost-3410-12-512-paramSetC
+    {"tc26-512-C", 512,
+     "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF"
+     "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFDC7",
+     "DC9203E514A721875485A529D2C722FB187BC8980EB866644DE41C68E1430645"
+     "46E861C0E2C9EDD92ADE71F46FCF50FF2AD97F951FDA9F2A2EB6546F39689BD3",
+     "B4C4EE28CEBC6C2C8AC12952CF37F16AC7EFB6A9F69F4B57FFDA2E4F0DE5ADE0"
+     "38CBC2FFF719D2C18DE0284B8BFEF3B52B8CC7A5F5BF0A3C8D2319A5312557E1",
+     "3FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF"
+     "C98CDBA46506AB004C33A9FF5147502CC8EDA9E7A769A12694623CEF47F023ED",
+     "E2E31EDFC23DE7BDEBE241CE593EF5DE2295B7A9CBAEF021D385F7074CEA043A"
+     "A27272A7AE602BF2A7B9033DB9ED3610C6FB85487EAE97AAC5BC7928C1950148",
+     "F5CE40D95B5EB899ABBCCFF5911CB8577939804D6527378B8C108C3D2090FF9B"
+     "E18E2D33E3021ED2EF32D85822423B6304F726AA854BAE07D0396E9A9ADDC40F"},
+};
+
+inline const CurveParams* find_curve_params(std::string_view name) {
+    for (const auto& params : kCurveParams) {
+        if (name == params.name) return &params;
+    }
+    return nullptr;
+}
+
+// Совместная разреженная форма (JSF, Солинас) пары скаляров: цифры u0, u1 из {-1, 0, 1},
+// младшие первыми. Среди любых трёх соседних позиций хотя бы одна пара нулевая,
+// поэтому ненулевых столбцов в среднем bits/2, а не 3*bits/4, как у двоичной записи.
+template <std::size_t N>
+struct JointSparseForm {
+    std::array<std::array<int8_t, 2>, 64 * N + 1> digits{};
+    std::size_t length = 0;
+};
+
+template <std::size_t N>
+JointSparseForm<N> joint_sparse_form(UInt<N> k0, UInt<N> k1) {
+    JointSparseForm<N> jsf;
+    int d0 = 0, d1 = 0;
+    while (!k0.is_zero() || d0 > 0 || !k1.is_zero() || d1 > 0) {
+        int l0 = (d0 + static_cast<int>(k0.limb[0] & 7)) & 7;
+        int l1 = (d1 + static_cast<int>(k1.limb[0] & 7)) & 7;
+        int u0 = 0, u1 = 0;
+        if (l0 & 1) {
+            u0 = (l0 & 3) == 1 ? 1 : -1;
+            if ((l0 == 3 || l0 == 5) && (l1 & 3) == 2) u0 = -u0;
+        }
+        if (l1 & 1) {
+            u1 = (l1 & 3) == 1 ? 1 : -1;
+            if ((l1 == 3 || l1 == 5) && (l0 & 3) == 2) u1 = -u1;
+        }
+        if (2 * d0 == 1 + u0) d0 = 1 - d0;
+        if (2 * d1 == 1 + u1) d1 = 1 - d1;
+        jsf.digits[jsf.length++] = {static_cast<int8_t>(u0), static_cast<int8_t>(u1)};
+        k0 = k0.shr1();
+        k1 = k1.shr1();
+    }
+    return jsf;
+}
+
+// Оконная несмежная форма (wNAF) ширины w: ненулевые цифры нечётны и по модулю меньше 2^(w-1),
+// между ними не менее w-1 нулей, поэтому сложений в среднем bits/(w+1). Младшие цифры первыми.
+template <std::size_t N>
+struct WindowNaf {
+    std::array<int8_t, 64 * N + 1> digits{};
+    std::size_t length = 0;
+};
+
+template <std::size_t N>
+WindowNaf<N> window_naf(UInt<N> k, unsigned w) {
+    if (w < 2 || w > 8) throw std::runtime_error("wNAF window must be in 2..8");
+    WindowNaf<N> naf;
+    const int modulus = 1 << w;
+    while (!k.is_zero()) {
+        int digit = 0;
+        if (k.limb[0] & 1) {
+            digit = static_cast<int>(k.limb[0] & (modulus - 1));
+            if (digit >= modulus / 2) {
+                digit -= modulus;
+                if (add_with_carry(k, k, UInt<N>::from_u64(-digit))) throw std::runtime_error("Scalar too large for wNAF");
+            } else {
+                sub_with_borrow(k, k, UInt<N>::from_u64(digit));
+            }
+        }
+        naf.digits[naf.length++] = static_cast<int8_t>(digit);
+        k = k.shr1();
+    }
+    return naf;
+}
+
+// Кривая в короткой форме Вейерштрасса над GF(p), N — число 64-битных слов
+template <std::size_t N>
+class EllipticCurve {
+public:
+    using Field = MontgomeryField<N>;
+    using Element = typename Field::Element;
+    using Scalar = UInt<N>;
+
+    // Аффинная точка, координаты в форме Монтгомери
+    struct Point {
+        Element x, y;
+        friend bool operator==(const Point& P, const Point& Q) { return P.x == Q.x && P.y == Q.y; }
+    };
+    // nullopt — бесконечно удалённая точка
+    using OptionalPoint = std::optional<Point>;
+
+    // Точка в координатах Якоби: (X : Y : Z) соответствует (X/Z^2, Y/Z^3), Z = 0 — бесконечность.
+    // Сложение и удвоение в этих координатах не требуют обращения элементов поля.
+    struct JacobianPoint {
+        Element X, Y, Z;
+    };
+
+    explicit EllipticCurve(const CurveParams& params)
+        : name_(params.name),
+          fp_(UInt<N>::from_hex(params.p)),
+          fq_(UInt<N>::from_hex(params.q)),
+          a_(fp_.from_hex(params.a)),
+          b_(fp_.from_hex(params.b)),
+          q_(UInt<N>::from_hex(params.q)),
+          G_(make_point(UInt<N>::from_hex(params.x), UInt<N>::from_hex(params.y))) {
+        Element minus3 = fp_.neg(fp_.from_u64(3));
+        a_is_minus3_ = (a_ == minus3);
+        if (!is_point_on_curve(G_)) throw std::runtime_error(std::string("Base point is not on curve ") + name_);
+    }
+
+    const char* name() const { return name_; }
+    const Field& field() const { return fp_; }
+    // Поле вычетов по модулю порядка подгруппы q — для арифметики скаляров подписи
+    const Field& scalar_field() const { return fq_; }
+    const Scalar& order() const { return q_; }
+    const Point& generator() const { return G_; }
+
+    Point make_point(const UInt<N>& x, const UInt<N>& y) const {
+        if (x >= fp_.modulus() || y >= fp_.modulus()) throw std::runtime_error("Point coordinate out of range");
+        return {fp_.from_uint(x), fp_.from_uint(y)};
+    }
+
+    std::pair<UInt<N>, UInt<N>> coordinates(const Point& P) const {
+        return {fp_.to_uint(P.x), fp_.to_uint(P.y)};
+    }
+
+    bool is_point_on_curve(const Point& P) const {
+        Element left = fp_.sqr(P.y);
+        Element right = fp_.add(fp_.mul(fp_.add(fp_.sqr(P.x), a_), P.x), b_);
+        return left == right;
+    }
+
+    OptionalPoint add_points(const OptionalPoint& P_opt, const OptionalPoint& Q_opt) const {
+        if (!P_opt.has_value()) return Q_opt;
+        if (!Q_opt.has_value()) return P_opt;
+
+        const Point& P = P_opt.value();
+        const Point& Q = Q_opt.value();
+
+        if (P.x == Q.x && fp_.is_zero(fp_.add(P.y, Q.y))) {
+            return std::nullopt;
+        }
+
+        Element lambda;
+        if (P == Q) {
+            // lambda = (3x^2 + a) / 2y
+            Element x2 = fp_.sqr(P.x);
+            Element num = fp_.add(fp_.add(fp_.add(x2, x2), x2), a_);
+            lambda = fp_.mul(num, fp_.inv(fp_.add(P.y, P.y)));
+        } else {
+            lambda = fp_.mul(fp_.sub(Q.y, P.y), fp_.inv(fp_.sub(Q.x, P.x)));
+        }
+
+        Element x3 = fp_.sub(fp_.sub(fp_.sqr(lambda), P.x), Q.x);
+        Element y3 = fp_.sub(fp_.mul(lambda, fp_.sub(P.x, x3)), P.y);
+        return Point{x3, y3};
+    }
+
+    JacobianPoint infinity() const { return {fp_.one(), fp_.one(), fp_.zero()}; }
+    bool is_infinity(const JacobianPoint& P) const { return fp_.is_zero(P.Z); }
+
+    JacobianPoint to_jacobian(const Point& P) const { return {P.x, P.y, fp_.one()}; }
+    JacobianPoint to_jacobian(const OptionalPoint& P) const { return P ? to_jacobian(*P) : infinity(); }
+
+    // Переход к аффинным координатам — единственное обращение за всё вычисление
+    OptionalPoint to_affine(const JacobianPoint& P) const {
+        if (is_infinity(P)) return std::nullopt;
+        return normalize_with_inverse(P, fp_.inv(P.Z));
+    }
+
+    // Перевод набора точек к аффинному виду с одним общим обращением на весь набор
+    std::vector<OptionalPoint> to_affine_batch(const std::vector<JacobianPoint>& points) const {
+        std::vector<Element> zinv(points.size());
+        for (std::size_t i = 0; i < points.size(); ++i) zinv[i] = points[i].Z;
+        fp_.inv_batch(zinv.data(), zinv.size());
+        std::vector<OptionalPoint> affine(points.size());
+        for (std::size_t i = 0; i < points.size(); ++i) {
+            if (!is_infinity(points[i])) affine[i] = normalize_with_inverse(points[i], zinv[i]);
+        }
+        return affine;
+    }
+
+    // Аффинная точка по известному Z^-1
+    Point normalize_with_inverse(const JacobianPoint& P, const Element& zinv) const {
+        Element zinv2 = fp_.sqr(zinv);
+        return {fp_.mul(P.X, zinv2), fp_.mul(fp_.mul(P.Y, zinv2), zinv)};
+    }
+
+    // Удвоение (dbl-2007-bl); при a = -3 используется M = 3(X - Z^2)(X + Z^2)
+    JacobianPoint double_point(const JacobianPoint& P) const {
+        Element XX = fp_.sqr(P.X);
+        Element YY = fp_.sqr(P.Y);
+        Element YYYY = fp_.sqr(YY);
+        Element ZZ = fp_.sqr(P.Z);
+
+        Element S = fp_.sub(fp_.sub(fp_.sqr(fp_.add(P.X, YY)), XX), YYYY);
+        S = fp_.add(S, S);
+
+        Element M;
+        if (a_is_minus3_) {
+            M = fp_.mul(fp_.sub(P.X, ZZ), fp_.add(P.X, ZZ));
+            M = fp_.add(fp_.add(M, M), M);
+        } else {
+            M = fp_.add(fp_.add(fp_.add(XX, XX), XX), fp_.mul(a_, fp_.sqr(ZZ)));
+        }
+
+        JacobianPoint R;
+        R.X = fp_.sub(fp_.sqr(M), fp_.add(S, S));
+        Element YYYY8 = fp_.add(YYYY, YYYY);
+        YYYY8 = fp_.add(YYYY8, YYYY8);
+        YYYY8 = fp_.add(YYYY8, YYYY8);
+        R.Y = fp_.sub(fp_.mul(M, fp_.sub(S, R.X)), YYYY8);
+        R.Z = fp_.sub(fp_.sub(fp_.sqr(fp_.add(P.Y, P.Z)), YY), ZZ);
+        return R;
+    }
+
+    // Сложение двух точек в координатах Якоби (add-2007-bl)
+    JacobianPoint add_jacobian(const JacobianPoint& P, const JacobianPoint& Q) const {
+        if (is_infinity(P)) return Q;
+        if (is_infinity(Q)) return P;
+
+        Element Z1Z1 = fp_.sqr(P.Z);
+        Element Z2Z2 = fp_.sqr(Q.Z);
+        Element U1 = fp_.mul(P.X, Z2Z2);
+        Element U2 = fp_.mul(Q.X, Z1Z1);
+        Element S1 = fp_.mul(fp_.mul(P.Y, Q.Z), Z2Z2);
+        Element S2 = fp_.mul(fp_.mul(Q.Y, P.Z), Z1Z1);
+
+        Element H = fp_.sub(U2, U1);
+        Element r = fp_.sub(S2, S1);
+        if (fp_.is_zero(H)) {
+            return fp_.is_zero(r) ? double_point(P) : infinity();
+        }
+        r = fp_.add(r, r);
+
+        Element I = fp_.sqr(fp_.add(H, H));
+        Element J = fp_.mul(H, I);
+        Element V = fp_.mul(U1, I);
+
+        JacobianPoint R;
+        R.X = fp_.sub(fp_.sub(fp_.sqr(r), J), fp_.add(V, V));
+        Element S1J = fp_.mul(S1, J);
+        R.Y = fp_.sub(fp_.mul(r, fp_.sub(V, R.X)), fp_.add(S1J, S1J));
+        R.Z = fp_.mul(fp_.sub(fp_.sub(fp_.sqr(fp_.add(P.Z, Q.Z)), Z1Z1), Z2Z2), H);
+        return R;
+    }
+
+    // Смешанное сложение: вторая точка аффинная, Z2 = 1 (madd-2007-bl)
+    JacobianPoint add_mixed(const JacobianPoint& P, const Point& Q) const {
+        if (is_infinity(P)) return to_jacobian(Q);
+
+        Element Z1Z1 = fp_.sqr(P.Z);
+        Element U2 = fp_.mul(Q.x, Z1Z1);
+        Element S2 = fp_.mul(fp_.mul(Q.y, P.Z), Z1Z1);
+
+        Element H = fp_.sub(U2, P.X);
+        Element r = fp_.sub(S2, P.Y);
+        if (fp_.is_zero(H)) {
+            return fp_.is_zero(r) ? double_point(P) : infinity();
+        }
+        r = fp_.add(r, r);
+
+        Element HH = fp_.sqr(H);
+        Element I = fp_.add(HH, HH);
+        I = fp_.add(I, I);
+        Element J = fp_.mul(H, I);
+        Element V = fp_.mul(P.X, I);
+
+        JacobianPoint R;
+        R.X = fp_.sub(fp_.sub(fp_.sqr(r), J), fp_.add(V, V));
+        Element Y1J = fp_.mul(P.Y, J);
+        R.Y = fp_.sub(fp_.mul(r, fp_.sub(V, R.X)), fp_.add(Y1J, Y1J));
+        R.Z = fp_.sub(fp_.sub(fp_.sqr(fp_.add(P.Z, H)), Z1Z1), HH);
+        return R;
+    }
+
+    static constexpr unsigned kDefaultWindow = 4;
+
+    // Нечётные кратные P, 3P, ..., (2^(w-1) - 1)P — таблица для wNAF ширины w
+    std::vector<JacobianPoint> odd_multiples(const Point& P, unsigned window) const {
+        std::vector<JacobianPoint> odd(std::size_t(1) << (window - 2));
+        odd[0] = to_jacobian(P);
+        JacobianPoint twice = double_point(odd[0]);
+        for (std::size_t i = 1; i < odd.size(); ++i) odd[i] = add_jacobian(odd[i - 1], twice);
+        return odd;
+    }
+
+    // k*P по wNAF без обращений; таблица нечётных кратных остаётся в координатах Якоби
+    JacobianPoint multiply_jacobian(const Point& P, const Scalar& k) const {
+        const auto naf = window_naf(k, kDefaultWindow);
+        const auto odd = odd_multiples(P, kDefaultWindow);
+        JacobianPoint result = infinity();
+        for (std::size_t i = naf.length; i-- > 0;) {
+            result = double_point(result);
+            int digit = naf.digits[i];
+            if (digit > 0) result = add_jacobian(result, odd[digit >> 1]);
+            else if (digit < 0) result = add_jacobian(result, negate(odd[-digit >> 1]));
+        }
+        return result;
+    }
+
+    OptionalPoint multiply_point(const Point& P, const Scalar& k) const {
+        return to_affine(multiply_jacobian(P, k));
+    }
+
+    // Аффинная таблица нечётных кратных точки для повторных умножений: строится один раз
+    // (например, для часто встречающегося открытого ключа), после чего каждое сложение смешанное
+    struct WnafTable {
+        unsigned window = 0;
+        std::vector<OptionalPoint> odd;   // odd[i] = (2i + 1)P
+    };
+
+    WnafTable make_wnaf_table(const Point& P, unsigned window = kDefaultWindow) const {
+        if (window < 2 || window > 8) throw std::runtime_error("wNAF window must be in 2..8");
+        return {window, to_affine_batch(odd_multiples(P, window))};
+    }
+
+    JacobianPoint multiply_wnaf(const WnafTable& table, const Scalar& k) const {
+        const auto naf = window_naf(k, table.window);
+        JacobianPoint result = infinity();
+        for (std::size_t i = naf.length; i-- > 0;) {
+            result = add_wnaf_digit(double_point(result), table, naf.digits[i]);
+        }
+        return result;
+    }
+
+    JacobianPoint negate(const JacobianPoint& P) const { return {P.X, fp_.neg(P.Y), P.Z}; }
+
+    OptionalPoint negate(const OptionalPoint& P) const {
+        if (!P) return std::nullopt;
+        return Point{P->x, fp_.neg(P->y)};
+    }
+
+    // Таблица для multiply_dual: entries[u0 + 1][u1 + 1] = u0*P + u1*Q, u0, u1 из {-1, 0, 1}.
+    // Зависит только от P и Q, поэтому для повторяющегося открытого ключа её можно строить один раз.
+    struct DualTable {
+        OptionalPoint entries[3][3];
+    };
+
+    // P + Q и P - Q приводятся к аффинному виду одним общим обращением
+    DualTable make_dual_table(const Point& P, const Point& Q) const {
+        auto affine = to_affine_batch({add_mixed(to_jacobian(P), Q),
+                                       add_mixed(to_jacobian(P), Point{Q.x, fp_.neg(Q.y)})});
+        const OptionalPoint& P_plus_Q = affine[0];
+        const OptionalPoint& P_minus_Q = affine[1];
+        return {{
+            {negate(P_plus_Q), negate(OptionalPoint(P)), negate(P_minus_Q)},
+            {negate(OptionalPoint(Q)), std::nullopt, OptionalPoint(Q)},
+            {P_minus_Q, OptionalPoint(P), P_plus_Q},
+        }};
+    }
+
+    // a*P + b*Q одной цепочкой удвоений (Штраус — Шамир) по совместной разреженной форме:
+    // на каждый разряд одно удвоение и не более одного смешанного сложения
+    JacobianPoint multiply_dual(const DualTable& table, const Scalar& a, const Scalar& b) const {
+        const auto jsf = joint_sparse_form(a, b);
+        JacobianPoint result = infinity();
+        for (std::size_t i = jsf.length; i-- > 0;) {
+            result = double_point(result);
+            const auto& entry = table.entries[jsf.digits[i][0] + 1][jsf.digits[i][1] + 1];
+            if (entry) result = add_mixed(result, *entry);
+        }
+        return result;
+    }
+
+    JacobianPoint multiply_dual(const Point& P, const Scalar& a, const Point& Q, const Scalar& b) const {
+        return multiply_dual(make_dual_table(P, Q), a, b);
+    }
+
+    // a*P + b*Q с заранее построенными таблицами: wNAF обоих скаляров на общей цепочке удвоений.
+    // Окна таблиц независимы — для G выгодно широкое, для ключа хватает узкого.
+    JacobianPoint multiply_dual(const WnafTable& P_table, const Scalar& a, const WnafTable& Q_table,
+                                const Scalar& b) const {
+        const auto naf_a = window_naf(a, P_table.window);
+        const auto naf_b = window_naf(b, Q_table.window);
+        JacobianPoint result = infinity();
+        for (std::size_t i = std::max(naf_a.length, naf_b.length); i-- > 0;) {
+            result = double_point(result);
+            result = add_wnaf_digit(result, P_table, naf_a.digits[i]);
+            result = add_wnaf_digit(result, Q_table, naf_b.digits[i]);
+        }
+        return result;
+    }
+
+private:
+    JacobianPoint add_wnaf_digit(const JacobianPoint& R, const WnafTable& table, int digit) const {
+        if (digit == 0) return R;
+        const auto& entry = table.odd[std::abs(digit) >> 1];
+        if (!entry) return R;
+        return add_mixed(R, digit > 0 ? *entry : Point{entry->x, fp_.neg(entry->y)});
+    }
+
+    const char* name_;
+    Field fp_, fq_;
+    Element a_, b_;
+    bool a_is_minus3_ = false;
+    Scalar q_;
+    Point G_;
+};
+
+#endif // ELLIPTIC_CURVE_H
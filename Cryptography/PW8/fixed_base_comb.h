@@ -0,0 +1,72 @@
+// fixed_base_comb.h
+#ifndef FIXED_BASE_COMB_H
+#define FIXED_BASE_COMB_H
+
+#include "elliptic_curve.h"
+
+#include <stdexcept>
+#include <vector>
+
+// Умножение фиксированной точки G методом гребёнки (Лим — Ли).
+// Скаляр k разбивается на teeth строк по spacing бит; таблица хранит все 2^teeth сумм
+// вида sum(b_i * 2^(i*spacing) * G), поэтому k*G стоит spacing удвоений и
+// spacing смешанных сложений вместо bits удвоений и ~bits/2 сложений.
+// Таблица строится при каждом запуске (пакетная нормализация — около миллисекунды) и на диск
+// не сохраняется: подменённая таблица с неверными кратными G раскрыла бы биты одноразовых k.
+template <std::size_t N>
+class FixedBaseComb {
+public:
+    using Curve = EllipticCurve<N>;
+    using Point = typename Curve::Point;
+    using OptionalPoint = typename Curve::OptionalPoint;
+    using JacobianPoint = typename Curve::JacobianPoint;
+    using Scalar = typename Curve::Scalar;
+
+    static constexpr unsigned kDefaultTeeth = 8;
+
+    FixedBaseComb(const Curve& curve, unsigned teeth = kDefaultTeeth)
+        : curve_(&curve), teeth_(teeth), spacing_(spacing_for(curve, teeth)), table_(std::size_t(1) << teeth) {
+        std::vector<JacobianPoint> jac(table_.size(), curve.infinity());
+        JacobianPoint base = curve.to_jacobian(curve.generator());
+        for (unsigned i = 0; i < teeth_; ++i) {
+            jac[std::size_t(1) << i] = base;
+            for (unsigned j = 0; j < spacing_; ++j) base = curve.double_point(base);
+        }
+        for (std::size_t idx = 3; idx < jac.size(); ++idx) {
+            std::size_t high = std::size_t(1) << (63 - __builtin_clzll(idx));
+            if (idx != high) jac[idx] = curve.add_jacobian(jac[idx ^ high], jac[high]);
+        }
+        table_ = curve.to_affine_batch(jac);
+    }
+
+    JacobianPoint multiply(const Scalar& k) const {
+        if (k.bit_length() > std::size_t(teeth_) * spacing_) {
+            throw std::runtime_error("Scalar is wider than the comb table");
+        }
+        JacobianPoint result = curve_->infinity();
+        for (std::size_t col = spacing_; col-- > 0;) {
+            result = curve_->double_point(result);
+            std::size_t idx = 0;
+            for (unsigned i = 0; i < teeth_; ++i) {
+                std::size_t pos = col + std::size_t(i) * spacing_;
+                if (pos < Scalar::kBits && k.bit(pos)) idx |= std::size_t(1) << i;
+            }
+            if (idx && table_[idx]) result = curve_->add_mixed(result, *table_[idx]);
+        }
+        return result;
+    }
+
+    OptionalPoint multiply_point(const Scalar& k) const { return curve_->to_affine(multiply(k)); }
+
+private:
+    static unsigned spacing_for(const Curve& curve, unsigned teeth) {
+        if (teeth == 0 || teeth > 16) throw std::runtime_error("Comb teeth must be in 1..16");
+        return static_cast<unsigned>((curve.order().bit_length() + teeth - 1) / teeth);
+    }
+
+    const Curve* curve_;
+    unsigned teeth_, spacing_;
+    std::vector<OptionalPoint> table_;   // table_[0] не используется
+};
+
+#endif // FIXED_BASE_COMB_H
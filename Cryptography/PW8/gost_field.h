@@ -0,0 +1,346 @@
+// gost_field.h
+#ifndef GOST_FIELD_H
+#define GOST_FIELD_H
+
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <sys/random.h>
+
+// Беззнаковое целое фиксированной ширины: N 64-битных слов, младшее слово первым.
+// Живёт целиком на стеке — никаких выделений памяти в арифметике.
+template <std::size_t N>
+struct UInt {
+    std::array<uint64_t, N> limb{};
+
+    static constexpr std::size_t kBits = 64 * N;
+
+    static UInt from_u64(uint64_t v) {
+        UInt r;
+        r.limb[0] = v;
+        return r;
+    }
+
+    // Шестнадцатеричная строка (допускается префикс 0x)
+    static UInt from_hex(std::string_view hex) {
+        if (hex.size() >= 2 && hex[0] == '0' && (hex[1] == 'x' || hex[1] == 'X')) hex.remove_prefix(2);
+        if (hex.empty()) throw std::runtime_error("Empty hex number");
+        UInt r;
+        std::size_t nibble = 0;
+        for (auto it = hex.rbegin(); it != hex.rend(); ++it, ++nibble) {
+            char c = *it;
+            uint64_t d;
+            if (c >= '0' && c <= '9') d = c - '0';
+            else if (c >= 'a' && c <= 'f') d = c - 'a' + 10;
+            else if (c >= 'A' && c <= 'F') d = c - 'A' + 10;
+            else throw std::runtime_error("Invalid hex digit in: " + std::string(hex));
+            if (d == 0) continue;
+            if (nibble >= 16 * N) throw std::runtime_error("Hex number too large: " + std::string(hex));
+            r.limb[nibble / 16] |= d << (4 * (nibble % 16));
+        }
+        return r;
+    }
+
+    // Байтовая строка big-endian длиной не более 8*N
+    static UInt from_bytes_be(const uint8_t* data, std::size_t len) {
+        if (len > 8 * N) throw std::runtime_error("Byte string too long for UInt");
+        UInt r;
+        for (std::size_t i = 0; i < len; ++i) {
+            std::size_t pos = len - 1 - i;
+            r.limb[pos / 8] |= static_cast<uint64_t>(data[i]) << (8 * (pos % 8));
+        }
+        return r;
+    }
+
+    // Байтовая строка little-endian длиной не более 8*N
+    static UInt from_bytes_le(const uint8_t* data, std::size_t len) {
+        if (len > 8 * N) throw std::runtime_error("Byte string too long for UInt");
+        UInt r;
+        for (std::size_t i = 0; i < len; ++i) r.limb[i / 8] |= static_cast<uint64_t>(data[i]) << (8 * (i % 8));
+        return r;
+    }
+
+    // Запись в 8*N байт big-endian
+    void to_bytes_be(uint8_t* out) const {
+        for (std::size_t i = 0; i < 8 * N; ++i) out[8 * N - 1 - i] = static_cast<uint8_t>(limb[i / 8] >> (8 * (i % 8)));
+    }
+
+    std::string to_hex() const {
+        static constexpr char digits[] = "0123456789abcdef";
+        std::string s;
+        for (std::size_t i = N; i-- > 0;) {
+            for (int shift = 60; shift >= 0; shift -= 4) {
+                char c = digits[(limb[i] >> shift) & 0xF];
+                if (s.empty() && c == '0') continue;
+                s.push_back(c);
+            }
+        }
+        return s.empty() ? "0" : s;
+    }
+
+    bool is_zero() const {
+        uint64_t acc = 0;
+        for (uint64_t w : limb) acc |= w;
+        return acc == 0;
+    }
+
+    bool bit(std::size_t i) const { return (limb[i / 64] >> (i % 64)) & 1; }
+
+    // Сдвиг вправо на один бит
+    UInt shr1() const {
+        UInt r;
+        for (std::size_t i = 0; i < N; ++i) {
+            r.limb[i] = limb[i] >> 1;
+            if (i + 1 < N) r.limb[i] |= limb[i + 1] << 63;
+        }
+        return r;
+    }
+
+    std::size_t bit_length() const {
+        for (std::size_t i = N; i-- > 0;) {
+            if (limb[i]) return 64 * i + 64 - __builtin_clzll(limb[i]);
+        }
+        return 0;
+    }
+
+    friend bool operator==(const UInt& a, const UInt& b) { return a.limb == b.limb; }
+    friend bool operator!=(const UInt& a, const UInt& b) { return a.limb != b.limb; }
+    friend bool operator<(const UInt& a, const UInt& b) {
+        for (std::size_t i = N; i-- > 0;) {
+            if (a.limb[i] != b.limb[i]) return a.limb[i] < b.limb[i];
+        }
+        return false;
+    }
+    friend bool operator>=(const UInt& a, const UInt& b) { return !(a < b); }
+};
+
+// r = a + b, возвращает перенос
+template <std::size_t N>
+inline uint64_t add_with_carry(UInt<N>& r, const UInt<N>& a, const UInt<N>& b) {
+    unsigned __int128 carry = 0;
+    for (std::size_t i = 0; i < N; ++i) {
+        carry += static_cast<unsigned __int128>(a.limb[i]) + b.limb[i];
+        r.limb[i] = static_cast<uint64_t>(carry);
+        carry >>= 64;
+    }
+    return static_cast<uint64_t>(carry);
+}
+
+// r = a - b, возвращает заём
+template <std::size_t N>
+inline uint64_t sub_with_borrow(UInt<N>& r, const UInt<N>& a, const UInt<N>& b) {
+    uint64_t borrow = 0;
+    for (std::size_t i = 0; i < N; ++i) {
+        unsigned __int128 diff = static_cast<unsigned __int128>(a.limb[i]) - b.limb[i] - borrow;
+        r.limb[i] = static_cast<uint64_t>(diff);
+        borrow = static_cast<uint64_t>(diff >> 64) & 1;
+    }
+    return borrow;
+}
+
+// Обнуление секретных слов; запись через volatile компилятор не выбрасывает как ненужную
+inline void secure_wipe(uint64_t* words, std::size_t count) {
+    volatile uint64_t* p = words;
+    for (std::size_t i = 0; i < count; ++i) p[i] = 0;
+}
+
+template <std::size_t N>
+void secure_wipe(UInt<N>& x) {
+    secure_wipe(x.limb.data(), N);
+}
+
+// Криптографически стойкий генератор 64-битных слов поверх getrandom() (пул ядра).
+// Источник всех секретных скаляров: закрытых ключей и одноразовых k подписи.
+// Слова читаются из ядра пачками; экземпляр не потокобезопасен.
+class SystemRandom {
+public:
+    using result_type = uint64_t;
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    SystemRandom() = default;
+    SystemRandom(const SystemRandom&) = delete;
+    SystemRandom& operator=(const SystemRandom&) = delete;
+
+    ~SystemRandom() {
+        // Неиспользованные слова — будущие секреты, в памяти их не оставляем
+        secure_wipe(buffer_.data(), buffer_.size());
+    }
+
+    result_type operator()() {
+        if (next_ == buffer_.size()) refill();
+        uint64_t word = buffer_[next_];
+        buffer_[next_++] = 0;
+        return word;
+    }
+
+private:
+    void refill() {
+        auto* bytes = reinterpret_cast<unsigned char*>(buffer_.data());
+        std::size_t size = sizeof(buffer_), done = 0;
+        while (done < size) {
+            ssize_t got = getrandom(bytes + done, size - done, 0);
+            if (got < 0) {
+                if (errno == EINTR) continue;
+                throw std::runtime_error("getrandom failed");
+            }
+            done += static_cast<std::size_t>(got);
+        }
+        next_ = 0;
+    }
+
+    std::array<uint64_t, 32> buffer_{};
+    std::size_t next_ = 32;
+};
+
+// Случайное 1 <= k < q; gen — генератор 64-битных слов. Для секретов — только SystemRandom;
+// std::mt19937_64 с фиксированным зерном допустим лишь в тестах и замерах
+template <std::size_t N, class Generator>
+UInt<N> random_scalar(const UInt<N>& q, Generator& gen) {
+    const std::size_t bits = q.bit_length();
+    while (true) {
+        UInt<N> k;
+        for (std::size_t i = 0; i < N; ++i) {
+            k.limb[i] = gen();
+            if (64 * i >= bits) k.limb[i] = 0;
+            else if (64 * (i + 1) > bits) k.limb[i] &= (uint64_t(1) << (bits - 64 * i)) - 1;
+        }
+        if (!k.is_zero() && k < q) return k;
+    }
+}
+
+// Простое поле GF(p) с умножением Монтгомери (CIOS), R = 2^(64N).
+// Элементы хранятся в форме Монтгомери x*R mod p и всегда полностью редуцированы,
+// поэтому сравнение элементов — это сравнение слов.
+template <std::size_t N>
+class MontgomeryField {
+public:
+    using Element = UInt<N>;
+
+    explicit MontgomeryField(const UInt<N>& p) : p_(p) {
+        if (!(p.limb[0] & 1)) throw std::runtime_error("Montgomery modulus must be odd");
+        // p' = -p^-1 mod 2^64 (итерация Ньютона удваивает число верных битов)
+        uint64_t inv = 1;
+        for (int i = 0; i < 6; ++i) inv *= 2 - p.limb[0] * inv;
+        pinv_ = ~inv + 1;
+
+        // R mod p и R^2 mod p удвоениями единицы
+        UInt<N> x = UInt<N>::from_u64(1);
+        for (std::size_t i = 0; i < 2 * UInt<N>::kBits; ++i) {
+            x = add(x, x);
+            if (i + 1 == UInt<N>::kBits) one_ = x;
+        }
+        r2_ = x;
+    }
+
+    const UInt<N>& modulus() const { return p_; }
+
+    Element zero() const { return Element{}; }
+    Element one() const { return one_; }
+
+    // Перевод в форму Монтгомери; допускается любое x < 2^(64N), не только x < p
+    Element from_uint(const UInt<N>& x) const { return mul(x, r2_); }
+    Element from_u64(uint64_t v) const { return from_uint(UInt<N>::from_u64(v)); }
+    Element from_hex(std::string_view hex) const { return from_uint(UInt<N>::from_hex(hex)); }
+
+    UInt<N> to_uint(const Element& a) const { return mul(a, UInt<N>::from_u64(1)); }
+
+    bool is_zero(const Element& a) const { return a.is_zero(); }
+
+    Element add(const Element& a, const Element& b) const {
+        Element r;
+        uint64_t carry = add_with_carry(r, a, b);
+        if (carry || r >= p_) sub_with_borrow(r, r, p_);
+        return r;
+    }
+
+    Element sub(const Element& a, const Element& b) const {
+        Element r;
+        if (sub_with_borrow(r, a, b)) add_with_carry(r, r, p_);
+        return r;
+    }
+
+    Element neg(const Element& a) const { return sub(zero(), a); }
+
+    Element mul(const Element& a, const Element& b) const {
+        uint64_t t[N + 2] = {};
+        for (std::size_t i = 0; i < N; ++i) {
+            unsigned __int128 c = 0;
+            for (std::size_t j = 0; j < N; ++j) {
+                c += static_cast<unsigned __int128>(a.limb[j]) * b.limb[i] + t[j];
+                t[j] = static_cast<uint64_t>(c);
+                c >>= 64;
+            }
+            c += t[N];
+            t[N] = static_cast<uint64_t>(c);
+            t[N + 1] = static_cast<uint64_t>(c >> 64);
+
+            uint64_t m = t[0] * pinv_;
+            c = static_cast<unsigned __int128>(m) * p_.limb[0] + t[0];
+            c >>= 64;
+            for (std::size_t j = 1; j < N; ++j) {
+                c += static_cast<unsigned __int128>(m) * p_.limb[j] + t[j];
+                t[j - 1] = static_cast<uint64_t>(c);
+                c >>= 64;
+            }
+            c += t[N];
+            t[N - 1] = static_cast<uint64_t>(c);
+            t[N] = t[N + 1] + static_cast<uint64_t>(c >> 64);
+        }
+        Element r;
+        for (std::size_t i = 0; i < N; ++i) r.limb[i] = t[i];
+        if (t[N] || r >= p_) sub_with_borrow(r, r, p_);
+        return r;
+    }
+
+    Element sqr(const Element& a) const { return mul(a, a); }
+
+    Element pow(const Element& a, const UInt<N>& e) const {
+        Element result = one_;
+        for (std::size_t i = e.bit_length(); i-- > 0;) {
+            result = sqr(result);
+            if (e.bit(i)) result = mul(result, a);
+        }
+        return result;
+    }
+
+    // Обратный элемент по малой теореме Ферма: a^(p-2); для нуля возвращает ноль
+    Element inv(const Element& a) const {
+        UInt<N> e;
+        sub_with_borrow(e, p_, UInt<N>::from_u64(2));
+        return pow(a, e);
+    }
+
+    // Обращение n элементов на месте одним обращением и ~3n умножениями (приём Монтгомери):
+    // a_i^-1 = (a_1...a_i)^-1 * (a_1...a_{i-1}). Нули, как и в inv, остаются нулями.
+    void inv_batch(Element* a, std::size_t n) const {
+        std::vector<Element> prefix(n);
+        Element acc = one_;
+        for (std::size_t i = 0; i < n; ++i) {
+            prefix[i] = acc;
+            if (!is_zero(a[i])) acc = mul(acc, a[i]);
+        }
+        Element acc_inv = inv(acc);
+        for (std::size_t i = n; i-- > 0;) {
+            if (is_zero(a[i])) continue;
+            Element a_inv = mul(acc_inv, prefix[i]);
+            acc_inv = mul(acc_inv, a[i]);
+            a[i] = a_inv;
+        }
+    }
+
+private:
+    UInt<N> p_;
+    uint64_t pinv_ = 0;
+    Element one_, r2_;
+};
+
+#endif // GOST_FIELD_H
@@ -1,9 +1,12 @@
+#include "batch_verify.h"
+#include "gost_signature.h"
+#include "sign_server.h"
+
 #include <iostream>
 #include <fstream>
 #include <optional>
 #include <tuple>
 #include <random>
-#include <openssl/sha.h>
 #include <filesystem>
 #include <string>
 #include <sstream>
@@ -11,221 +14,128 @@
 #include <vector>
 
 using namespace std;
-using Point = pair<int, int>;
-using OptionalPoint = optional<Point>;
 
-tuple<int, int, int> extended_gcd(int a, int b) {
-    if (a == 0) {
-        return {b, 0, 1};
-    }
-    auto [gcd, x1, y1] = extended_gcd(b % a, a);
-    int x = y1 - (b / a) * x1;
-    int y = x1;
-    return {gcd, x, y};
-}
-
-optional<int> mod_inverse(int a, int m) {
-    auto [gcd, x, y] = extended_gcd(a, m);
-    if (gcd != 1) {
-        return nullopt;
-    }
-    return (x % m + m) % m;
+template <size_t N>
+void write_signature(const string& path, const pair<UInt<N>, UInt<N>>& signature) {
+    INSTRUMENT_SCOPE("write");
+    ofstream out(path);
+    if (!out) throw runtime_error("Cannot write signature: " + path);
+    out << signature.first.to_hex() << " " << signature.second.to_hex();
 }
 
-class EllipticCurve {
-private:
-    int a, b, p;
+// Подпись (mode == "sign") или проверка подписи файла; возвращает результат проверки
+template <size_t N>
+bool process_file(const string& input_file, const string& output_file,
+                  const EllipticCurve<N>& curve, const FixedBaseComb<N>& comb,
+                  const pair<UInt<N>, Point<N>>& key, const string& mode) {
+    auto h = hash_file<N>(input_file);
 
-public:
-    EllipticCurve(int a, int b, int p) : a(a), b(b), p(p) {}
-
-    bool is_point_on_curve(const Point& P) const {
-        int x = P.first;
-        int y = P.second;
-        int left = (y * y) % p;
-        int right = (x*x*x + a*x + b) % p;
-        return left == right;
+    if (mode == "sign") {
+        const auto& d = key.first;
+        write_signature(output_file, sign_hash(h, curve, comb, d));
+        return true;
     }
 
-    OptionalPoint add_points(const OptionalPoint& P_opt, const OptionalPoint& Q_opt) const {
-        if (!P_opt.has_value()) return Q_opt;
-        if (!Q_opt.has_value()) return P_opt;
-
-        Point P = P_opt.value();
-        Point Q = Q_opt.value();
-        int x1 = P.first, y1 = P.second;
-        int x2 = Q.first, y2 = Q.second;
-
-        if (x1 == x2 && (y1 + y2) % p == 0) {
-            return nullopt;
-        }
-
-        int lambda;
-        if (P == Q) {
-            if (y1 == 0) return nullopt;
-            int denominator = (2 * y1) % p;
-            auto inv = mod_inverse(denominator, p);
-            if (!inv) return nullopt;
-            lambda = ((3 * x1*x1 + a) * inv.value()) % p;
-        } else {
-            int denominator = (x2 - x1) % p;
-            auto inv = mod_inverse(denominator, p);
-            if (!inv) return nullopt;
-            lambda = ((y2 - y1) * inv.value()) % p;
-        }
-
-        int x3 = (lambda*lambda - x1 - x2) % p;
-        x3 = (x3 + p) % p;
-        int y3 = (lambda*(x1 - x3) - y1) % p;
-        y3 = (y3 + p) % p;
+    auto signature = read_signature<N>(output_file);
+    return verify_signature(h, signature, curve, key.second);
+}
 
-        return make_pair(x3, y3);
+// Манифест подписи: строки <файл сообщения> <файл подписи>
+vector<pair<string, string>> read_sign_manifest(const string& path) {
+    if (!filesystem::exists(path)) {
+        throw runtime_error("Manifest not found: " + path);
     }
-
-    OptionalPoint multiply_point(const Point& P, int k) const {
-        OptionalPoint result = nullopt;
-        OptionalPoint addend = P;
-
-        while (k > 0) {
-            if (k & 1) {
-                result = add_points(result, addend);
-            }
-            addend = add_points(addend, addend);
-            k >>= 1;
+    ifstream in(path);
+    vector<pair<string, string>> files;
+    string line;
+    for (size_t line_no = 1; getline(in, line); ++line_no) {
+        if (line.empty() || line[0] == '#') continue;
+        istringstream fields(line);
+        string message_file, signature_file;
+        if (!(fields >> message_file >> signature_file)) {
+            throw runtime_error("Malformed manifest line " + to_string(line_no));
         }
-
-        return result;
+        files.emplace_back(message_file, signature_file);
     }
-};
-
-int hash_message(const string& message) {
-    unsigned char digest[SHA256_DIGEST_LENGTH];
-    SHA256(reinterpret_cast<const unsigned char*>(message.data()), message.size(), digest);
-
-    int result = 0;
-    for (int i = 0; i < 4; ++i) {
-        result = (result << 8) | digest[i];
-    }
-    return result;
+    return files;
 }
 
-pair<int, Point> generate_keypair(const EllipticCurve& curve, const Point& G, int q) {
-    random_device rd;
-    mt19937 gen(rd());
-    uniform_int_distribution<> dis(1, q-1);
-
-    while (true) {
-        int d = dis(gen);
-        auto Q_opt = curve.multiply_point(G, d);
-        if (Q_opt.has_value() && curve.is_point_on_curve(Q_opt.value())) {
-            return {d, Q_opt.value()};
-        }
-    }
+// Пакетная подпись по манифесту: все k*G пачки нормализуются вместе; возвращает число подписей
+template <size_t N>
+size_t batch_sign(const string& manifest_file, const EllipticCurve<N>& curve, const FixedBaseComb<N>& comb,
+                  const UInt<N>& d) {
+    auto files = read_sign_manifest(manifest_file);
+    vector<UInt<N>> hashes;
+    for (const auto& [message_file, signature_file] : files) hashes.push_back(hash_file<N>(message_file));
+
+    auto signatures = sign_hashes(hashes, curve, comb, d);
+    for (size_t i = 0; i < files.size(); ++i) write_signature(files[i].second, signatures[i]);
+    return files.size();
 }
 
-pair<int, int> sign_message(const string& message, const EllipticCurve& curve, const Point& G, int q, int d) {
-    int h = hash_message(message);
-    int e = h % q;
-    if (e == 0) e = 1;
-
-    random_device rd;
-    mt19937 gen(rd());
-    uniform_int_distribution<> dis(1, q-1);
-
-    while (true) {
-        int k = dis(gen);
-        auto P_opt = curve.multiply_point(G, k);
-        if (!P_opt) continue;
-
-        int r = P_opt->first % q;
-        if (r == 0) continue;
-
-        int s = (r * d + k * e) % q;
-        if (s == 0) continue;
-
-        return {r, s};
+// Подпись по манифесту с пулом одноразовых пар: умножения на G идут в фоновом потоке
+// параллельно с чтением и хэшированием файлов
+template <size_t N>
+size_t pool_sign(const string& manifest_file, const EllipticCurve<N>& curve, const FixedBaseComb<N>& comb,
+                 const UInt<N>& d) {
+    auto files = read_sign_manifest(manifest_file);
+    NoncePool<N> nonces(curve, comb);
+    for (const auto& [message_file, signature_file] : files) {
+        write_signature(signature_file, sign_hash(hash_file<N>(message_file), curve, nonces, d));
     }
+    return files.size();
 }
 
-bool verify_signature(const string& message, const pair<int, int>& signature, 
-                     const EllipticCurve& curve, const Point& G, int q, const Point& Q) {
-    auto [r, s] = signature;
-
-    if (r <= 0 || r >= q || s <= 0 || s >= q) return false;
-    if (!curve.is_point_on_curve(Q)) return false;
-
-    int h = hash_message(message);
-    int e = h % q;
-    if (e == 0) e = 1;
-
-    auto v_opt = mod_inverse(e, q);
-    if (!v_opt) return false;
-    int v = v_opt.value();
-
-    int z1 = (s * v) % q;
-    int z2 = (-r * v) % q;
-    z2 = (z2 + q) % q;
-
-    auto P1 = curve.multiply_point(G, z1);
-    auto P2 = curve.multiply_point(Q, z2);
-    auto C = curve.add_points(P1, P2);
+template <size_t N>
+int run(const CurveParams& params, const string& mode) {
+    EllipticCurve<N> curve(params);
+    // Таблица гребёнки для G строится один раз на запуск
+    FixedBaseComb<N> comb(curve);
 
-    if (!C) return false;
-    return (C->first % q + q) % q == r;
-}
-
-void process_file(const string& input_file, const string& output_file, 
-                 const EllipticCurve& curve, const Point& G, int q,
-                 const pair<int, Point>& key, const string& mode) {
-    if (!filesystem::exists(input_file)) {
-        throw runtime_error("File not found: " + input_file);
+    if (mode == "generate") {
+        auto [d, Q] = generate_keypair(curve, comb);
+        auto [x, y] = curve.coordinates(Q);
+        cout << "Секретный ключ: " << d.to_hex() << "\nПубличный ключ: ("
+             << x.to_hex() << ", " << y.to_hex() << ")\n";
+        return 0;
     }
 
-    ifstream in(input_file, ios::binary);
-    string msg((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
-    in.close();
-
-    if (mode == "sign") {
-        auto [d, _] = key;
-        auto [r, s] = sign_message(msg, curve, G, q, d);
-        ofstream out(output_file);
-        out << r << " " << s;
-        out.close();
-    } else {
-        if (!filesystem::exists(output_file)) {
-            throw runtime_error("Signature file not found: " + output_file);
+    if (mode == "batch-generate") {
+        size_t count = 0;
+        cout << "Количество ключей: "; cin >> count;
+        for (const auto& [d, Q] : generate_keypairs(curve, comb, count)) {
+            auto [x, y] = curve.coordinates(Q);
+            cout << "Секретный ключ: " << d.to_hex() << "\nПубличный ключ: ("
+                 << x.to_hex() << ", " << y.to_hex() << ")\n";
         }
-        ifstream sig_file(output_file);
-        int r, s;
-        sig_file >> r >> s;
-        sig_file.close();
-
-        auto [_, Q] = key;
-        bool ok = verify_signature(msg, {r, s}, curve, G, q, Q);
-        ofstream result("verify_result.txt");
-        result << (ok ? "Подпись верна" : "Подпись неверна");
-        result.close();
+        return 0;
     }
-}
 
-int main() {
-    int p = 17, a = 2, b = 2, q = 19;
-    EllipticCurve curve(a, b, p);
-    Point G = {5, 1};
+    if (mode == "batch-sign" || mode == "pool-sign") {
+        string manifest, d;
+        cout << "Файл манифеста: "; cin >> manifest;
+        cout << "Секретный ключ: "; cin >> d;
+        auto key = UInt<N>::from_hex(d);
+        size_t count = mode == "batch-sign" ? batch_sign(manifest, curve, comb, key)
+                                            : pool_sign(manifest, curve, comb, key);
+        cout << "Подписано файлов: " << count << '\n';
+        return 0;
+    }
 
-    cout << "ГОСТ Р 34.10-2012 (C++ реализация)\n";
-    string mode;
-    while (true) {
-        cout << "Выберите операцию (generate/sign/verify): ";
-        cin >> mode;
-        if (mode == "generate" || mode == "sign" || mode == "verify") break;
-        cout << "Некорректный режим!\n";
+    if (mode == "serve") {
+        string socket_path, d;
+        cout << "Путь к сокету: "; cin >> socket_path;
+        cout << "Секретный ключ (- только для проверки): "; cin >> d;
+        serve(socket_path, curve, comb, d == "-" ? optional<UInt<N>>() : UInt<N>::from_hex(d));
+        return 0;
     }
 
-    if (mode == "generate") {
-        auto [d, Q] = generate_keypair(curve, G, q);
-        cout << "Секретный ключ: " << d << "\nПубличный ключ: (" 
-             << Q.first << ", " << Q.second << ")\n";
+    if (mode == "batch-verify") {
+        string manifest, results;
+        cout << "Файл манифеста: "; cin >> manifest;
+        cout << "Файл результатов: "; cin >> results;
+        auto [ok, bad, errors] = batch_verify(manifest, results, curve);
+        cout << "Верных подписей: " << ok << ", неверных: " << bad << ", ошибок: " << errors << '\n';
         return 0;
     }
 
@@ -234,20 +144,53 @@ int main() {
     cout << "Файл подписи: "; cin >> sig_file;
 
     if (mode == "sign") {
-        int d;
+        string d;
         cout << "Секретный ключ: "; cin >> d;
-        process_file(msg_file, sig_file, curve, G, q, {d, {}}, "sign");
+        process_file<N>(msg_file, sig_file, curve, comb, {UInt<N>::from_hex(d), {}}, "sign");
         cout << "Подпись создана\n";
     } else {
-        int x, y;
+        string x, y;
         cout << "Публичный ключ (x y): "; cin >> x >> y;
-        process_file(msg_file, sig_file, curve, G, q, {0, {x, y}}, "verify");
-        
-        ifstream result("verify_result.txt");
-        string res;
-        getline(result, res);
-        cout << "Результат: " << res << endl;
+        auto Q = curve.make_point(UInt<N>::from_hex(x), UInt<N>::from_hex(y));
+        bool ok = process_file<N>(msg_file, sig_file, curve, comb, {UInt<N>{}, Q}, "verify");
+        cout << "Результат: " << (ok ? "Подпись верна" : "Подпись неверна") << endl;
     }
 
     return 0;
-}
\ No newline at end of file
+}
+
+int main(int argc, char* argv[]) {
+    instrumentation::Session stats(argc, argv);
+    cout << "ГОСТ Р 34.10-2012 (C++ реализация)\n";
+    cout << "Наборы параметров:";
+    for (const auto& params : kCurveParams) cout << ' ' << params.name;
+    cout << '\n';
+
+    const CurveParams* params = nullptr;
+    while (true) {
+        string name;
+        cout << "Выберите набор параметров: ";
+        cin >> name;
+        params = find_curve_params(name);
+        if (params) break;
+        cout << "Неизвестный набор параметров!\n";
+    }
+
+    string mode;
+    while (true) {
+        cout << "Выберите операцию (generate/sign/verify/batch-generate/batch-sign/pool-sign/batch-verify/serve): ";
+        cin >> mode;
+        if (mode == "generate" || mode == "sign" || mode == "verify" || mode == "batch-generate" ||
+            mode == "batch-sign" || mode == "pool-sign" || mode == "batch-verify" || mode == "serve") {
+            break;
+        }
+        cout << "Некорректный режим!\n";
+    }
+
+    try {
+        return params->bits == 256 ? run<4>(*params, mode) : run<8>(*params, mode);
+    } catch (const exception& e) {
+        cerr << "Ошибка: " << e.what() << endl;
+        return 1;
+    }
+}
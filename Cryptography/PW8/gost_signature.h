@@ -0,0 +1,245 @@
+// gost_signature.h
+#ifndef GOST_SIGNATURE_H
+#define GOST_SIGNATURE_H
+
+#include "elliptic_curve.h"
+#include "fixed_base_comb.h"
+#include "key_cache.h"
+#include "nonce_pool.h"
+#include "streebog.h"
+#include "../common/instrumentation.h"
+
+#include <cstddef>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Подпись и проверка ГОСТ Р 34.10-2012 поверх кривой, гребёнки G, кэша ключей и пула одноразовых
+// пар. Общая часть утилиты gost_sign, тестов и замеров производительности.
+
+template <size_t N>
+using Point = typename EllipticCurve<N>::Point;
+
+template <size_t N>
+using OptionalPoint = typename EllipticCurve<N>::OptionalPoint;
+
+// Хэш-код Стрибог (256 или 512 бит по размеру кривой) файла как число: вектор h стандарта
+// хранится младшим байтом вперёд. Файл читается блоками фиксированного размера,
+// без загрузки в память целиком.
+template <size_t N>
+UInt<N> hash_file(const std::string& path) {
+    static_assert(N == 4 || N == 8, "GOST R 34.10-2012 defines 256- and 512-bit curves only");
+    std::ifstream in(path, std::ios::binary);
+    if (!in) throw std::runtime_error("File not found: " + path);
+    Streebog hash(64 * N);
+    std::vector<char> chunk(1 << 16);
+    while (true) {
+        {
+            INSTRUMENT_SCOPE("read");
+            if (!in.read(chunk.data(), chunk.size()) && in.gcount() == 0) break;
+        }
+        INSTRUMENT_COUNT("bytes_in", in.gcount());
+        INSTRUMENT_SCOPE("hash");
+        hash.update(chunk.data(), in.gcount());
+    }
+    if (in.bad()) throw std::runtime_error("Read error: " + path);
+    INSTRUMENT_SCOPE("hash_final");
+    uint8_t digest[8 * N];
+    hash.final(digest);
+    return UInt<N>::from_bytes_le(digest, sizeof(digest));
+}
+
+// e = h mod q, e = 1 при нулевом остатке; результат в форме Монтгомери по модулю q
+template <size_t N>
+typename EllipticCurve<N>::Element hash_to_scalar(const UInt<N>& h, const EllipticCurve<N>& curve) {
+    const auto& fq = curve.scalar_field();
+    auto e = fq.from_uint(h);
+    if (fq.is_zero(e)) e = fq.one();
+    return e;
+}
+
+template <size_t N, class Generator>
+std::pair<UInt<N>, Point<N>> generate_keypair(const EllipticCurve<N>& curve, const FixedBaseComb<N>& comb,
+                                              Generator& gen) {
+    while (true) {
+        UInt<N> d = random_scalar(curve.order(), gen);
+        INSTRUMENT_SCOPE("scalar_mult");
+        auto Q_opt = comb.multiply_point(d);
+        if (Q_opt.has_value() && curve.is_point_on_curve(Q_opt.value())) {
+            return {d, Q_opt.value()};
+        }
+    }
+}
+
+template <size_t N>
+std::pair<UInt<N>, Point<N>> generate_keypair(const EllipticCurve<N>& curve, const FixedBaseComb<N>& comb) {
+    SystemRandom gen;
+    return generate_keypair(curve, comb, gen);
+}
+
+// Одноразовые k берутся из gen; генератор с фиксированным зерном — только для тестов и воспроизводимых замеров
+template <size_t N, class Generator>
+std::pair<UInt<N>, UInt<N>> sign_hash(const UInt<N>& h, const EllipticCurve<N>& curve,
+                                      const FixedBaseComb<N>& comb, const UInt<N>& d, Generator& gen) {
+    const auto& fq = curve.scalar_field();
+    auto e = hash_to_scalar(h, curve);
+    auto d_m = fq.from_uint(d);
+
+    while (true) {
+        UInt<N> k = random_scalar(curve.order(), gen);
+        OptionalPoint<N> P_opt;
+        {
+            INSTRUMENT_SCOPE("scalar_mult");
+            P_opt = comb.multiply_point(k);
+        }
+        if (!P_opt) continue;
+
+        auto r = fq.from_uint(curve.field().to_uint(P_opt->x));
+        if (fq.is_zero(r)) continue;
+
+        auto s = fq.add(fq.mul(r, d_m), fq.mul(fq.from_uint(k), e));
+        if (fq.is_zero(s)) continue;
+
+        INSTRUMENT_COUNT("signatures", 1);
+        return {fq.to_uint(r), fq.to_uint(s)};
+    }
+}
+
+template <size_t N>
+std::pair<UInt<N>, UInt<N>> sign_hash(const UInt<N>& h, const EllipticCurve<N>& curve,
+                                      const FixedBaseComb<N>& comb, const UInt<N>& d) {
+    SystemRandom gen;
+    return sign_hash(h, curve, comb, d, gen);
+}
+
+// Пакетная генерация: открытые ключи всех пар приводятся к аффинному виду одним общим обращением
+template <size_t N>
+std::vector<std::pair<UInt<N>, Point<N>>> generate_keypairs(const EllipticCurve<N>& curve,
+                                                             const FixedBaseComb<N>& comb, size_t count) {
+    SystemRandom gen;
+
+    std::vector<UInt<N>> d(count);
+    std::vector<typename EllipticCurve<N>::JacobianPoint> Q(count);
+    std::vector<OptionalPoint<N>> Q_affine;
+    {
+        INSTRUMENT_SCOPE("scalar_mult");
+        for (size_t i = 0; i < count; ++i) {
+            d[i] = random_scalar(curve.order(), gen);
+            Q[i] = comb.multiply(d[i]);
+        }
+        Q_affine = curve.to_affine_batch(Q);
+    }
+
+    std::vector<std::pair<UInt<N>, Point<N>>> keys;
+    keys.reserve(count);
+    // 0 < d < q, поэтому d*G не бесконечность
+    for (size_t i = 0; i < count; ++i) keys.emplace_back(d[i], Q_affine[i].value());
+    return keys;
+}
+
+// Пакетная подпись набора хэшей одним ключом: точки k_i*G нормализуются одним общим обращением
+template <size_t N>
+std::vector<std::pair<UInt<N>, UInt<N>>> sign_hashes(const std::vector<UInt<N>>& hashes,
+                                                     const EllipticCurve<N>& curve, const FixedBaseComb<N>& comb,
+                                                     const UInt<N>& d) {
+    const auto& fq = curve.scalar_field();
+    auto d_m = fq.from_uint(d);
+
+    SystemRandom gen;
+
+    std::vector<UInt<N>> k(hashes.size());
+    std::vector<typename EllipticCurve<N>::JacobianPoint> C(hashes.size());
+    std::vector<OptionalPoint<N>> C_affine;
+    {
+        INSTRUMENT_SCOPE("scalar_mult");
+        for (size_t i = 0; i < hashes.size(); ++i) {
+            k[i] = random_scalar(curve.order(), gen);
+            C[i] = comb.multiply(k[i]);
+        }
+        C_affine = curve.to_affine_batch(C);
+    }
+
+    std::vector<std::pair<UInt<N>, UInt<N>>> signatures(hashes.size());
+    for (size_t i = 0; i < hashes.size(); ++i) {
+        auto r = fq.from_uint(curve.field().to_uint(C_affine[i].value().x));
+        auto s = fq.add(fq.mul(r, d_m), fq.mul(fq.from_uint(k[i]), hash_to_scalar(hashes[i], curve)));
+        // r = 0 или s = 0 практически невероятны; такую подпись проще повторить отдельно
+        if (fq.is_zero(r) || fq.is_zero(s)) {
+            signatures[i] = sign_hash(hashes[i], curve, comb, d);
+        } else {
+            signatures[i] = {fq.to_uint(r), fq.to_uint(s)};
+            INSTRUMENT_COUNT("signatures", 1);
+        }
+    }
+    return signatures;
+}
+
+// Подпись с парой (k, r) из пула: k*G уже вычислено в фоновом потоке
+template <size_t N>
+std::pair<UInt<N>, UInt<N>> sign_hash(const UInt<N>& h, const EllipticCurve<N>& curve, NoncePool<N>& nonces,
+                                      const UInt<N>& d) {
+    const auto& fq = curve.scalar_field();
+    auto e = hash_to_scalar(h, curve);
+    auto d_m = fq.from_uint(d);
+
+    while (true) {
+        auto nonce = nonces.take();
+        auto s = fq.add(fq.mul(nonce.r, d_m), fq.mul(fq.from_uint(nonce.k), e));
+        secure_wipe(nonce.k);
+        if (fq.is_zero(s)) continue;
+        INSTRUMENT_COUNT("signatures", 1);
+        return {fq.to_uint(nonce.r), fq.to_uint(s)};
+    }
+}
+
+// Общая часть проверки; multiply(z1, z2) вычисляет C = z1*G + z2*Q в координатах Якоби
+template <size_t N, class Multiply>
+bool verify_with(const UInt<N>& h, const std::pair<UInt<N>, UInt<N>>& signature, const EllipticCurve<N>& curve,
+                 Multiply multiply) {
+    const auto& fq = curve.scalar_field();
+    const auto& q = curve.order();
+    auto [r, s] = signature;
+
+    if (r.is_zero() || r >= q || s.is_zero() || s >= q) return false;
+
+    auto e = hash_to_scalar(h, curve);
+    auto v = fq.inv(e);
+
+    auto z1 = fq.mul(fq.from_uint(s), v);
+    auto z2 = fq.neg(fq.mul(fq.from_uint(r), v));
+
+    INSTRUMENT_COUNT("verifications", 1);
+    OptionalPoint<N> C;
+    {
+        INSTRUMENT_SCOPE("scalar_mult");
+        C = curve.to_affine(multiply(fq.to_uint(z1), fq.to_uint(z2)));
+    }
+
+    if (!C) return false;
+    return fq.to_uint(fq.from_uint(curve.field().to_uint(C->x))) == r;
+}
+
+// Разовая проверка: z1*G + z2*Q одной цепочкой удвоений по JSF, без таблиц ключа
+template <size_t N>
+bool verify_signature(const UInt<N>& h, const std::pair<UInt<N>, UInt<N>>& signature,
+                      const EllipticCurve<N>& curve, const Point<N>& Q) {
+    if (!curve.is_point_on_curve(Q)) return false;
+    return verify_with(h, signature, curve, [&](const UInt<N>& z1, const UInt<N>& z2) {
+        return curve.multiply_dual(curve.generator(), z1, Q, z2);
+    });
+}
+
+// Проверка с таблицами G и Q из кэша: выгодна, когда подписи одного ключа проверяются многократно
+template <size_t N>
+bool verify_signature(const UInt<N>& h, const std::pair<UInt<N>, UInt<N>>& signature,
+                      const EllipticCurve<N>& curve, KeyCache<N>& keys, const Point<N>& Q) {
+    if (!curve.is_point_on_curve(Q)) return false;
+    auto key_table = keys.get(Q);
+    return verify_with(h, signature, curve, [&](const UInt<N>& z1, const UInt<N>& z2) {
+        return curve.multiply_dual(keys.generator_table(), z1, *key_table, z2);
+    });
+}
+
+#endif // GOST_SIGNATURE_H
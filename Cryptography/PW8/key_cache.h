@@ -0,0 +1,99 @@
+// key_cache.h
+#ifndef KEY_CACHE_H
+#define KEY_CACHE_H
+
+#include "elliptic_curve.h"
+
+#include <array>
+#include <cstddef>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+
+// Ограниченный LRU-кэш таблиц нечётных кратных открытых ключей для проверки подписей.
+// Проверяющий обычно видит небольшой набор подписантов, поэтому таблица ключа окупается
+// уже на нескольких подписях, а ограничение размера не даёт кэшу расти на потоке
+// одноразовых ключей. Безопасен для одновременного использования из нескольких потоков.
+template <std::size_t N>
+class KeyCache {
+public:
+    using Curve = EllipticCurve<N>;
+    using Point = typename Curve::Point;
+    using WnafTable = typename Curve::WnafTable;
+
+    static constexpr std::size_t kDefaultCapacity = 256;
+    static constexpr unsigned kDefaultKeyWindow = 5;
+    // Таблица G одна на кривую, поэтому для неё окно шире
+    static constexpr unsigned kGeneratorWindow = 8;
+
+    explicit KeyCache(const Curve& curve, std::size_t capacity = kDefaultCapacity,
+                      unsigned key_window = kDefaultKeyWindow)
+        : curve_(&curve),
+          capacity_(capacity ? capacity : 1),
+          key_window_(key_window),
+          generator_table_(curve.make_wnaf_table(curve.generator(), kGeneratorWindow)) {}
+
+    const WnafTable& generator_table() const { return generator_table_; }
+
+    // Таблица для точки Q (Q должна лежать на кривой); при промахе строится вне блокировки
+    std::shared_ptr<const WnafTable> get(const Point& Q) {
+        const Key key = key_of(Q);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = index_.find(key);
+            if (it != index_.end()) {
+                ++hits_;
+                lru_.splice(lru_.begin(), lru_, it->second);
+                return it->second->second;
+            }
+            ++misses_;
+        }
+
+        auto table = std::make_shared<const WnafTable>(curve_->make_wnaf_table(Q, key_window_));
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = index_.find(key);
+        if (it != index_.end()) return it->second->second;   // другой поток успел раньше
+        lru_.emplace_front(key, table);
+        index_[key] = lru_.begin();
+        if (lru_.size() > capacity_) {
+            index_.erase(lru_.back().first);
+            lru_.pop_back();
+        }
+        return table;
+    }
+
+    std::size_t hits() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return hits_;
+    }
+
+    std::size_t misses() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return misses_;
+    }
+
+private:
+    using Key = std::array<uint64_t, 2 * N>;
+    using Entry = std::pair<Key, std::shared_ptr<const WnafTable>>;
+
+    static Key key_of(const Point& Q) {
+        Key key;
+        std::copy(Q.x.limb.begin(), Q.x.limb.end(), key.begin());
+        std::copy(Q.y.limb.begin(), Q.y.limb.end(), key.begin() + N);
+        return key;
+    }
+
+    const Curve* curve_;
+    std::size_t capacity_;
+    unsigned key_window_;
+    WnafTable generator_table_;
+
+    mutable std::mutex mutex_;
+    std::list<Entry> lru_;   // от недавно использованных к давно использованным
+    std::map<Key, typename std::list<Entry>::iterator> index_;
+    std::size_t hits_ = 0, misses_ = 0;
+};
+
+#endif // KEY_CACHE_H
@@ -0,0 +1,121 @@
+// nonce_pool.h
+#ifndef NONCE_POOL_H
+#define NONCE_POOL_H
+
+#include "elliptic_curve.h"
+#include "fixed_base_comb.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Пул заранее вычисленных одноразовых пар (k, r = x(k*G) mod q) для подписи.
+// Фоновый поток пополняет пул пачками (точки пачки нормализуются одним обращением),
+// поэтому на пути запроса подписи остаются только хэш и несколько умножений по модулю q.
+// Каждая пара выдаётся ровно один раз и сразу удаляется из пула; k в пуле и во временных
+// векторах затирается, как только копия больше не нужна, и при уничтожении пула.
+template <std::size_t N>
+class NoncePool {
+public:
+    using Curve = EllipticCurve<N>;
+    using Element = typename Curve::Element;
+
+    struct Nonce {
+        UInt<N> k;
+        Element r;   // в форме Монтгомери по модулю q, r != 0
+    };
+
+    static constexpr std::size_t kDefaultCapacity = 1024;
+    static constexpr std::size_t kRefillBatch = 64;
+
+    // curve и comb должны жить дольше пула
+    NoncePool(const Curve& curve, const FixedBaseComb<N>& comb, std::size_t capacity = kDefaultCapacity)
+        : curve_(&curve), comb_(&comb), capacity_(std::max(capacity, kRefillBatch)),
+          worker_([this] { refill_loop(); }) {}
+
+    NoncePool(const NoncePool&) = delete;
+    NoncePool& operator=(const NoncePool&) = delete;
+
+    ~NoncePool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        not_full_.notify_all();
+        worker_.join();
+        for (auto& nonce : nonces_) secure_wipe(nonce.k);
+    }
+
+    // Извлечь пару из пула; если пул пуст, ждать фоновый поток
+    Nonce take() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_empty_.wait(lock, [this] { return !nonces_.empty(); });
+        Nonce nonce = nonces_.front();
+        secure_wipe(nonces_.front().k);
+        nonces_.pop_front();
+        if (nonces_.size() + kRefillBatch <= capacity_) not_full_.notify_one();
+        return nonce;
+    }
+
+    std::size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return nonces_.size();
+    }
+
+private:
+    void refill_loop() {
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                not_full_.wait(lock, [this] { return stop_ || nonces_.size() + kRefillBatch <= capacity_; });
+                if (stop_) return;
+            }
+            auto batch = make_batch();
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                nonces_.insert(nonces_.end(), batch.begin(), batch.end());
+            }
+            for (auto& nonce : batch) secure_wipe(nonce.k);
+            not_empty_.notify_all();
+        }
+    }
+
+    std::vector<Nonce> make_batch() {
+        const auto& fq = curve_->scalar_field();
+
+        std::vector<UInt<N>> k(kRefillBatch);
+        std::vector<typename Curve::JacobianPoint> C(kRefillBatch);
+        for (std::size_t i = 0; i < kRefillBatch; ++i) {
+            k[i] = random_scalar(curve_->order(), gen_);
+            C[i] = comb_->multiply(k[i]);
+        }
+        auto C_affine = curve_->to_affine_batch(C);
+
+        std::vector<Nonce> batch;
+        batch.reserve(kRefillBatch);
+        for (std::size_t i = 0; i < kRefillBatch; ++i) {
+            Element r = fq.from_uint(curve_->field().to_uint(C_affine[i].value().x));
+            if (!fq.is_zero(r)) batch.push_back({k[i], r});
+            secure_wipe(k[i]);
+        }
+        return batch;
+    }
+
+    const Curve* curve_;
+    const FixedBaseComb<N>* comb_;
+    std::size_t capacity_;
+    SystemRandom gen_;   // одноразовые k — из getrandom(); используется только фоновым потоком
+
+    mutable std::mutex mutex_;
+    std::condition_variable not_empty_, not_full_;
+    std::deque<Nonce> nonces_;
+    bool stop_ = false;
+
+    std::thread worker_;   // последним: поток стартует, когда остальные члены уже готовы
+};
+
+#endif // NONCE_POOL_H
@@ -0,0 +1,375 @@
+// sign_server.h
+#ifndef SIGN_SERVER_H
+#define SIGN_SERVER_H
+
+#include "gost_signature.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// Служба подписи и проверки на локальном Unix-сокете. Кривая, ключ, таблица гребёнки,
+// пул одноразовых пар, кэш таблиц открытых ключей и пул рабочих потоков создаются один раз при запуске.
+//
+// Кадр (все целые little-endian): uint32 длина тела, затем тело
+//   запрос:  uint8 операция, uint32 номер запроса, данные
+//   ответ:   uint8 статус,   uint32 номер запроса, данные
+// Операции:
+//   kOpSign   данные — сообщение; ответ kStatusOk, r || s
+//   kOpVerify данные — Qx || Qy || r || s || сообщение; ответ kStatusOk (верна) или kStatusInvalid
+// Числа — big-endian по 8*N байт. При ошибке статус kStatusError, данные — текст ошибки.
+// Клиент может отправлять запросы, не дожидаясь ответов; ответы на соединении идут в порядке
+// запросов. Все полные кадры, накопившиеся за одно пробуждение, обрабатываются одной пачкой.
+// Пока у соединения больше kMaxPendingOutput неотправленных ответов, его запросы не читаются.
+//
+// Сокет создаётся с правами 0600: подключиться (и получить подпись) может только владелец
+// процесса. Для доступа других пользователей сокет нужно класть в каталог с нужными правами.
+// По пути сокета не должно быть ничего, кроме сокета прошлого запуска.
+namespace server {
+
+constexpr uint8_t kOpSign = 1;
+constexpr uint8_t kOpVerify = 2;
+
+constexpr uint8_t kStatusOk = 0;
+constexpr uint8_t kStatusInvalid = 1;
+constexpr uint8_t kStatusError = 2;
+
+constexpr size_t kHeaderSize = 4;
+constexpr size_t kMaxFrameSize = 64 << 20;
+constexpr size_t kMaxPendingOutput = 1 << 20;
+
+// Выставляется обработчиком SIGINT/SIGTERM (или другим потоком); serve завершается
+// в течение одного периода poll. Атомарный bool без блокировок допустим в обработчике сигнала.
+inline std::atomic<bool> stop_requested{false};
+static_assert(std::atomic<bool>::is_always_lock_free);
+
+inline uint32_t load_u32(const char* p) {
+    uint32_t v = 0;
+    for (int i = 3; i >= 0; --i) v = (v << 8) | static_cast<uint8_t>(p[i]);
+    return v;
+}
+
+inline void append_u32(std::string& out, uint32_t v) {
+    for (int i = 0; i < 4; ++i, v >>= 8) out.push_back(static_cast<char>(v & 0xFF));
+}
+
+struct Connection {
+    int fd;
+    std::string in, out;
+    bool closing = false;
+};
+
+struct Request {
+    Request(size_t connection, uint8_t op, uint32_t id, std::string payload)
+        : connection(connection), op(op), id(id), payload(std::move(payload)) {}
+
+    size_t connection;
+    uint8_t op;
+    uint32_t id;
+    std::string payload;
+    // заполняется при обработке
+    uint8_t status = kStatusError;
+    std::string response;
+};
+
+// Удаляет сокет, оставшийся от прошлого запуска; любой другой файл по этому пути не трогается
+inline void remove_socket_file(const std::string& path) {
+    struct stat st;
+    if (lstat(path.c_str(), &st) < 0) {
+        if (errno == ENOENT) return;
+        throw std::runtime_error("lstat " + path + ": " + std::strerror(errno));
+    }
+    if (!S_ISSOCK(st.st_mode)) throw std::runtime_error("Not a socket, refusing to replace: " + path);
+    unlink(path.c_str());
+}
+
+// Постоянный пул потоков для пачек запросов: потоки создаются один раз при запуске службы,
+// а не на каждое пробуждение. Вызывающий поток тоже разбирает индексы; пачка из одного
+// запроса выполняется им же, без пробуждения пула.
+class WorkerPool {
+public:
+    // threads = 0 — по числу аппаратных потоков (вместе с вызывающим)
+    explicit WorkerPool(unsigned threads = 0) {
+        if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned t = 1; t < threads; ++t) workers_.emplace_back([this] { work(); });
+    }
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        start_.notify_all();
+        for (auto& t : workers_) t.join();
+    }
+
+    // task(i) для всех i из [0, count); возвращается, когда все вызовы завершены.
+    // task не должна бросать исключений.
+    void run(size_t count, const std::function<void(size_t)>& task) {
+        if (count <= 1 || workers_.empty()) {
+            for (size_t i = 0; i < count; ++i) task(i);
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            task_ = &task;
+            count_ = count;
+            next_ = 0;
+            busy_ = workers_.size();
+            ++generation_;
+        }
+        start_.notify_all();
+        drain();
+        std::unique_lock<std::mutex> lock(mutex_);
+        finished_.wait(lock, [this] { return busy_ == 0; });
+        task_ = nullptr;
+    }
+
+private:
+    // task_ и count_ записаны под блокировкой до смены поколения и до следующей пачки не меняются
+    void drain() {
+        for (size_t i; (i = next_.fetch_add(1)) < count_;) (*task_)(i);
+    }
+
+    void work() {
+        uint64_t seen = 0;
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            start_.wait(lock, [&] { return stop_ || generation_ != seen; });
+            if (stop_) return;
+            seen = generation_;
+            lock.unlock();
+            drain();
+            lock.lock();
+            if (--busy_ == 0) finished_.notify_one();
+        }
+    }
+
+    std::mutex mutex_;
+    std::condition_variable start_, finished_;
+    const std::function<void(size_t)>* task_ = nullptr;
+    size_t count_ = 0;
+    std::atomic<size_t> next_{0};
+    size_t busy_ = 0;            // потоков пула, ещё не закончивших текущую пачку
+    uint64_t generation_ = 0;    // номер пачки; смена будит потоки пула
+    bool stop_ = false;
+
+    std::vector<std::thread> workers_;   // последним: потоки стартуют, когда остальные члены уже готовы
+};
+
+} // namespace server
+
+template <size_t N>
+void handle_request(server::Request& request, const EllipticCurve<N>& curve, NoncePool<N>* nonces,
+                    const std::optional<UInt<N>>& d, KeyCache<N>& keys) {
+    using namespace server;
+    constexpr size_t kNumberSize = 8 * N;
+    auto number = [&](size_t index) {
+        return UInt<N>::from_bytes_be(reinterpret_cast<const uint8_t*>(request.payload.data()) + index * kNumberSize,
+                                      kNumberSize);
+    };
+    auto append_number = [&](const UInt<N>& v) {
+        uint8_t bytes[kNumberSize];
+        v.to_bytes_be(bytes);
+        request.response.append(reinterpret_cast<const char*>(bytes), kNumberSize);
+    };
+
+    try {
+        if (request.op == kOpSign) {
+            if (!d) throw std::runtime_error("Signing key is not loaded");
+            Streebog hash(64 * N);
+            hash.update(request.payload.data(), request.payload.size());
+            uint8_t digest[8 * N];
+            hash.final(digest);
+            auto [r, s] = sign_hash(UInt<N>::from_bytes_le(digest, sizeof(digest)), curve, *nonces, *d);
+            append_number(r);
+            append_number(s);
+            request.status = kStatusOk;
+        } else if (request.op == kOpVerify) {
+            if (request.payload.size() < 4 * kNumberSize) throw std::runtime_error("Verify request too short");
+            auto x = number(0), y = number(1);
+            if (x >= curve.field().modulus() || y >= curve.field().modulus()) {
+                request.status = kStatusInvalid;
+                return;
+            }
+            Streebog hash(64 * N);
+            hash.update(request.payload.data() + 4 * kNumberSize, request.payload.size() - 4 * kNumberSize);
+            uint8_t digest[8 * N];
+            hash.final(digest);
+            bool valid = verify_signature(UInt<N>::from_bytes_le(digest, sizeof(digest)), {number(2), number(3)},
+                                          curve, keys, curve.make_point(x, y));
+            request.status = valid ? kStatusOk : kStatusInvalid;
+        } else {
+            throw std::runtime_error("Unknown operation " + std::to_string(request.op));
+        }
+    } catch (const std::exception& e) {
+        request.status = kStatusError;
+        request.response = e.what();
+    }
+}
+
+// Принимает соединения на socket_path до stop_requested; d не задан — служба только проверяет подписи
+template <size_t N>
+void serve(const std::string& socket_path, const EllipticCurve<N>& curve, const FixedBaseComb<N>& comb,
+           const std::optional<UInt<N>>& d) {
+    using namespace server;
+
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0) throw std::runtime_error("socket: " + std::string(std::strerror(errno)));
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (socket_path.size() >= sizeof(addr.sun_path)) {
+        close(listener);
+        throw std::runtime_error("Socket path too long: " + socket_path);
+    }
+    std::strcpy(addr.sun_path, socket_path.c_str());
+    try {
+        remove_socket_file(socket_path);
+    } catch (const std::exception&) {
+        close(listener);
+        throw;
+    }
+    // Права 0600 задаются уже при создании: между bind и chmod сокет был бы доступен всем
+    mode_t old_umask = umask(077);
+    int bound = bind(listener, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+    umask(old_umask);
+    if (bound < 0 || listen(listener, 64) < 0) {
+        std::string error = std::strerror(errno);
+        close(listener);
+        throw std::runtime_error("Cannot listen on " + socket_path + ": " + error);
+    }
+    fcntl(listener, F_SETFL, O_NONBLOCK);
+
+    std::signal(SIGINT, [](int) { stop_requested = true; });
+    std::signal(SIGTERM, [](int) { stop_requested = true; });
+    std::signal(SIGPIPE, SIG_IGN);
+
+    std::optional<NoncePool<N>> nonces;
+    if (d) nonces.emplace(curve, comb);
+    KeyCache<N> keys(curve);
+    WorkerPool workers;
+    std::vector<Connection> connections;
+
+    std::cout << "Служба запущена: " << socket_path << std::endl;
+    while (!stop_requested) {
+        // fds[i + 1] соответствует connections[i]; новые соединения добавляются только в конце итерации
+        std::vector<pollfd> fds{{listener, POLLIN, 0}};
+        for (const auto& c : connections) {
+            short events = c.out.size() < kMaxPendingOutput ? POLLIN : 0;
+            if (!c.out.empty()) events |= POLLOUT;
+            fds.push_back({c.fd, events, 0});
+        }
+        if (poll(fds.data(), fds.size(), 200) < 0) {
+            if (errno == EINTR) continue;
+            throw std::runtime_error("poll: " + std::string(std::strerror(errno)));
+        }
+
+        // Чтение и разбор всех полных кадров со всех соединений в одну пачку
+        std::vector<Request> batch;
+        for (size_t i = 0; i < connections.size(); ++i) {
+            auto& c = connections[i];
+            if (!(fds[i + 1].revents & (POLLIN | POLLHUP | POLLERR))) continue;
+            // Клиент не забирает ответы: новые запросы ждут в ядре, пока очередь не разойдётся
+            if (c.out.size() >= kMaxPendingOutput) continue;
+            char buffer[1 << 16];
+            while (true) {
+                ssize_t n = read(c.fd, buffer, sizeof(buffer));
+                if (n > 0) c.in.append(buffer, n);
+                if (n > 0 && static_cast<size_t>(n) == sizeof(buffer)) continue;
+                if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) c.closing = true;
+                break;
+            }
+            size_t pos = 0;
+            while (c.in.size() - pos >= kHeaderSize) {
+                size_t length = load_u32(c.in.data() + pos);
+                if (length < 5 || length > kMaxFrameSize) {
+                    c.closing = true;
+                    break;
+                }
+                if (c.in.size() - pos < kHeaderSize + length) break;
+                const char* body = c.in.data() + pos + kHeaderSize;
+                batch.emplace_back(i, static_cast<uint8_t>(body[0]), load_u32(body + 1),
+                                   std::string(body + 5, length - 5));
+                pos += kHeaderSize + length;
+            }
+            c.in.erase(0, pos);
+        }
+
+        workers.run(batch.size(), [&](size_t i) {
+            handle_request(batch[i], curve, nonces ? &*nonces : nullptr, d, keys);
+        });
+
+        for (const auto& request : batch) {
+            auto& out = connections[request.connection].out;
+            append_u32(out, static_cast<uint32_t>(5 + request.response.size()));
+            out.push_back(static_cast<char>(request.status));
+            append_u32(out, request.id);
+            out += request.response;
+        }
+
+        for (auto& c : connections) {
+            while (!c.out.empty()) {
+                ssize_t n = write(c.fd, c.out.data(), c.out.size());
+                if (n > 0) {
+                    c.out.erase(0, n);
+                    continue;
+                }
+                if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+                if (n < 0 && errno == EINTR) continue;
+                c.out.clear();
+                c.closing = true;
+            }
+        }
+
+        // Закрытое клиентом соединение держится, пока не отправлены ответы на уже принятые запросы
+        connections.erase(std::remove_if(connections.begin(), connections.end(), [](const Connection& c) {
+            if (!c.closing || !c.out.empty()) return false;
+            close(c.fd);
+            return true;
+        }), connections.end());
+
+        // Новые соединения — после проходов чтения и записи: у них ещё нет записи в fds
+        if (fds[0].revents & POLLIN) {
+            for (int fd; (fd = accept(listener, nullptr, nullptr)) >= 0;) {
+                fcntl(fd, F_SETFL, O_NONBLOCK);
+                connections.push_back({fd, {}, {}});
+            }
+        }
+    }
+
+    for (const auto& c : connections) close(c.fd);
+    close(listener);
+    try {
+        remove_socket_file(socket_path);
+    } catch (const std::exception&) {
+        // путь подменён во время работы — чужой файл не удаляем
+    }
+    std::cout << "Служба остановлена" << std::endl;
+}
+
+#endif // SIGN_SERVER_H
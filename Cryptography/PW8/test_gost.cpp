@@ -0,0 +1,386 @@
+#include "batch_verify.h"
+#include "gost_signature.h"
+#include "sign_server.h"
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <set>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+std::string to_hex(const uint8_t* data, size_t size) {
+    static const char digits[] = "0123456789abcdef";
+    std::string hex;
+    for (size_t i = 0; i < size; ++i) {
+        hex += digits[data[i] >> 4];
+        hex += digits[data[i] & 0xF];
+    }
+    return hex;
+}
+
+void testStreebog() {
+    // Контрольный пример 1 из ГОСТ Р 34.11-2012 (байты дайджеста в порядке вывода)
+    const char* message = "012345678901234567890123456789012345678901234567890123456789012";
+    uint8_t digest[64];
+
+    Streebog hash512(512);
+    hash512.update(message, std::strlen(message));
+    hash512.final(digest);
+    assert(to_hex(digest, 64) ==
+           "1b54d01a4af5b9d5cc3d86d68d285462b19abc2475222f35c085122be4ba1ffa"
+           "00ad30f8767b3a82384c6574f024c311e2a481332b08ef7f41797891c1646f48");
+
+    Streebog hash256(256);
+    hash256.update(message, std::strlen(message));
+    hash256.final(digest);
+    assert(to_hex(digest, 32) == "9d151eefd8590b89daa6ba6cb74af9275dd051026bb149a452fd84e5e57b5500");
+
+    std::cout << "[PASS] Streebog test vectors" << std::endl;
+}
+
+void testStandardExample() {
+    // Контрольный пример 1 из ГОСТ Р 34.10-2012
+    EllipticCurve<4> curve(*find_curve_params("test-256"));
+    FixedBaseComb<4> comb(curve);
+
+    auto d = UInt<4>::from_hex("7A929ADE789BB9BE10ED359DD39A72C11B60961F49397EEE1D19CE9891EC3B28");
+    auto Q = curve.make_point(UInt<4>::from_hex("7F2B49E270DB6D90D8595BEC458B50C58585BA1D4E9B788F6689DBD8E56FD80B"),
+                              UInt<4>::from_hex("26F1B489D6701DD185C8413A977B3CBBAF64D1C593D26627DFFB101A87FF77DA"));
+    assert(curve.is_point_on_curve(Q));
+    assert(curve.coordinates(comb.multiply_point(d).value()) == curve.coordinates(Q));
+    assert(curve.coordinates(curve.multiply_point(curve.generator(), d).value()) == curve.coordinates(Q));
+
+    auto h = UInt<4>::from_hex("2DFBC1B372D89A1188C09C52E0EEC61FCE52032AB1022E8E67ECE6672B043EE5");
+    std::pair<UInt<4>, UInt<4>> signature = {
+        UInt<4>::from_hex("41AA28D2F1AB148280CD9ED56FEDA41974053554A42767B83AD043FD39DC0493"),
+        UInt<4>::from_hex("01456C64BA4642A1653C235A98A60249BCD6D3F746B631DF928014F6C5BF9C40")};
+    assert(verify_signature(h, signature, curve, Q));
+
+    KeyCache<4> keys(curve);
+    assert(verify_signature(h, signature, curve, keys, Q));
+
+    std::cout << "[PASS] GOST R 34.10-2012 example test" << std::endl;
+}
+
+template <size_t N>
+void testSignVerify(const char* name) {
+    EllipticCurve<N> curve(*find_curve_params(name));
+    FixedBaseComb<N> comb(curve);
+    std::mt19937_64 gen(1);
+
+    auto [d, Q] = generate_keypair(curve, comb, gen);
+    auto h = random_scalar(curve.order(), gen);
+    auto signature = sign_hash(h, curve, comb, d, gen);
+    assert(verify_signature(h, signature, curve, Q));
+
+    KeyCache<N> keys(curve);
+    assert(verify_signature(h, signature, curve, keys, Q));
+
+    auto tampered = signature;
+    tampered.second = tampered.first;
+    assert(!verify_signature(h, tampered, curve, Q));
+    assert(!verify_signature(h, tampered, curve, keys, Q));
+
+    std::cout << "[PASS] Sign/verify test (" << name << ")" << std::endl;
+}
+
+template <size_t N>
+void testBatchInversion(const char* name) {
+    EllipticCurve<N> curve(*find_curve_params(name));
+    const auto& fp = curve.field();
+    std::mt19937_64 gen(3);
+
+    // Нули и повторы вперемешку с обычными элементами, нуль на краях
+    using Element = typename EllipticCurve<N>::Element;
+    std::vector<Element> a;
+    a.push_back(fp.zero());
+    for (int i = 0; i < 10; ++i) a.push_back(fp.from_uint(random_scalar(fp.modulus(), gen)));
+    a.push_back(a[3]);
+    a.push_back(fp.zero());
+    a.push_back(fp.one());
+    a.push_back(a[3]);
+    a.push_back(fp.zero());
+
+    auto inverted = a;
+    fp.inv_batch(inverted.data(), inverted.size());
+    for (size_t i = 0; i < a.size(); ++i) {
+        assert(inverted[i] == fp.inv(a[i]));
+        if (!fp.is_zero(a[i])) assert(fp.mul(a[i], inverted[i]) == fp.one());
+    }
+    fp.inv_batch(inverted.data(), 0);
+
+    // Точки с Z != 1, бесконечность и повтор; каждая сравнивается с отдельным to_affine
+    FixedBaseComb<N> comb(curve);
+    std::vector<typename EllipticCurve<N>::JacobianPoint> points{curve.infinity()};
+    for (int i = 0; i < 6; ++i) points.push_back(comb.multiply(random_scalar(curve.order(), gen)));
+    points.push_back(curve.infinity());
+    points.push_back(points[2]);
+    auto affine = curve.to_affine_batch(points);
+    assert(affine.size() == points.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+        auto expected = curve.to_affine(points[i]);
+        assert(affine[i].has_value() == expected.has_value());
+        if (expected) assert(*affine[i] == *expected && curve.is_point_on_curve(*affine[i]));
+    }
+    assert(curve.to_affine_batch({}).empty());
+
+    std::cout << "[PASS] Batch inversion test (" << name << ")" << std::endl;
+}
+
+template <size_t N>
+void testBatchSign(const char* name) {
+    EllipticCurve<N> curve(*find_curve_params(name));
+    FixedBaseComb<N> comb(curve);
+    KeyCache<N> keys(curve);
+    std::mt19937_64 gen(4);
+
+    auto pairs = generate_keypairs(curve, comb, 5);
+    assert(pairs.size() == 5);
+    for (const auto& [d, Q] : pairs) {
+        assert(curve.is_point_on_curve(Q));
+        assert(comb.multiply_point(d).value() == Q);
+    }
+
+    const auto& [d, Q] = pairs[0];
+    std::vector<UInt<N>> hashes;
+    for (int i = 0; i < 8; ++i) hashes.push_back(random_scalar(curve.order(), gen));
+    hashes.push_back(hashes[0]);
+    auto signatures = sign_hashes(hashes, curve, comb, d);
+    assert(signatures.size() == hashes.size());
+    for (size_t i = 0; i < hashes.size(); ++i) {
+        assert(verify_signature(hashes[i], signatures[i], curve, Q));
+        assert(verify_signature(hashes[i], signatures[i], curve, keys, Q));
+        assert(!verify_signature(hashes[i], signatures[i], curve, pairs[1].second));
+    }
+    // Одинаковые хэши подписываются разными k
+    assert(signatures[0].first != signatures.back().first);
+    assert(sign_hashes(std::vector<UInt<N>>{}, curve, comb, d).empty());
+
+    std::cout << "[PASS] Batch key generation and signing test (" << name << ")" << std::endl;
+}
+
+void testNoncePool() {
+    EllipticCurve<4> curve(*find_curve_params("tc26-256-A"));
+    FixedBaseComb<4> comb(curve);
+    const auto& fq = curve.scalar_field();
+    std::mt19937_64 gen(5);
+    auto [d, Q] = generate_keypair(curve, comb, gen);
+
+    // Пул минимального размера: выборка втрое больше ёмкости требует нескольких пополнений
+    NoncePool<4> pool(curve, comb, NoncePool<4>::kRefillBatch);
+    std::set<UInt<4>> seen;
+    for (size_t i = 0; i < 3 * NoncePool<4>::kRefillBatch; ++i) {
+        auto nonce = pool.take();
+        assert(!nonce.k.is_zero() && nonce.k < curve.order());
+        assert(!fq.is_zero(nonce.r));
+        auto P = comb.multiply_point(nonce.k).value();
+        assert(nonce.r == fq.from_uint(curve.field().to_uint(P.x)));
+        assert(seen.insert(nonce.k).second);
+    }
+    assert(pool.size() <= NoncePool<4>::kRefillBatch);
+
+    KeyCache<4> keys(curve);
+    std::set<UInt<4>> r_seen;
+    for (int i = 0; i < 20; ++i) {
+        auto h = random_scalar(curve.order(), gen);
+        auto signature = sign_hash(h, curve, pool, d);
+        assert(verify_signature(h, signature, curve, keys, Q));
+        assert(r_seen.insert(signature.first).second);
+    }
+
+    std::cout << "[PASS] Nonce pool test" << std::endl;
+}
+
+void testBatchVerify() {
+    EllipticCurve<4> curve(*find_curve_params("tc26-256-A"));
+    FixedBaseComb<4> comb(curve);
+    std::mt19937_64 gen(2);
+    auto [d, Q] = generate_keypair(curve, comb, gen);
+    auto [x, y] = curve.coordinates(Q);
+    std::string key = x.to_hex() + " " + y.to_hex();
+
+    // Верная подпись, подпись чужого сообщения, отсутствующее сообщение и неразборчивая строка
+    const char* files[] = {"test_gost_1.msg", "test_gost_1.sig", "test_gost_2.msg", "test_gost_2.sig"};
+    std::ofstream(files[0]) << "first message";
+    std::ofstream(files[2]) << "second message";
+    auto first = sign_hash(hash_file<4>(files[0]), curve, comb, d, gen);
+    std::ofstream(files[1]) << first.first.to_hex() << " " << first.second.to_hex();
+    std::ofstream(files[3]) << first.first.to_hex() << " " << first.second.to_hex();
+
+    const char* manifest = "test_gost.manifest";
+    const char* results = "test_gost.results";
+    std::ofstream(manifest) << "# message signature Qx Qy\n"
+                            << files[0] << " " << files[1] << " " << key << "\n"
+                            << files[2] << " " << files[3] << " " << key << "\n"
+                            << "test_gost_missing.msg " << files[1] << " " << key << "\n"
+                            << "test_gost_short.msg\n";
+
+    auto counts = batch_verify(manifest, results, curve, 2);
+    assert(counts[0] == 1 && counts[1] == 1 && counts[2] == 2);
+
+    std::ifstream in(results);
+    std::vector<std::string> lines;
+    for (std::string line; std::getline(in, line);) lines.push_back(line);
+    assert(lines.size() == 4);
+    assert(lines[0] == "OK  test_gost_1.msg");
+    assert(lines[1] == "BAD test_gost_2.msg");
+    assert(lines[2].rfind("ERR test_gost_missing.msg: ", 0) == 0);
+    assert(lines[3] == "ERR test_gost_short.msg: malformed manifest line 5");
+
+    for (const char* file : files) std::remove(file);
+    std::remove(manifest);
+    std::remove(results);
+    std::cout << "[PASS] Batch verify test" << std::endl;
+}
+
+// Клиент службы подписи для теста: кадры в формате sign_server.h
+class ServerClient {
+public:
+    explicit ServerClient(const std::string& path) {
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        std::strcpy(addr.sun_path, path.c_str());
+        // Служба запускается в соседнем потоке: ждём, пока сокет начнёт принимать соединения
+        for (int attempt = 0; attempt < 500; ++attempt) {
+            fd_ = socket(AF_UNIX, SOCK_STREAM, 0);
+            assert(fd_ >= 0);
+            if (connect(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0) return;
+            close(fd_);
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        assert(!"server did not start");
+    }
+    ~ServerClient() { close(fd_); }
+
+    void send(uint8_t op, uint32_t id, const std::string& payload) {
+        std::string frame;
+        server::append_u32(frame, static_cast<uint32_t>(5 + payload.size()));
+        frame.push_back(static_cast<char>(op));
+        server::append_u32(frame, id);
+        frame += payload;
+        for (size_t done = 0; done < frame.size();) {
+            ssize_t n = write(fd_, frame.data() + done, frame.size() - done);
+            assert(n > 0);
+            done += n;
+        }
+    }
+
+    // Статус, номер запроса и данные ответа
+    std::tuple<uint8_t, uint32_t, std::string> receive() {
+        std::string body = read_exact(server::load_u32(read_exact(4).data()));
+        return {static_cast<uint8_t>(body[0]), server::load_u32(body.data() + 1), body.substr(5)};
+    }
+
+private:
+    std::string read_exact(size_t size) {
+        std::string data(size, '\0');
+        for (size_t done = 0; done < size;) {
+            ssize_t n = read(fd_, &data[done], size - done);
+            assert(n > 0);
+            done += n;
+        }
+        return data;
+    }
+
+    int fd_ = -1;
+};
+
+void testServer() {
+    EllipticCurve<4> curve(*find_curve_params("tc26-256-A"));
+    FixedBaseComb<4> comb(curve);
+    std::mt19937_64 gen(6);
+    auto [d, Q] = generate_keypair(curve, comb, gen);
+
+    const std::string path = "test_gost.sock";
+    server::stop_requested = false;
+    std::thread service([&] { serve<4>(path, curve, comb, d); });
+
+    auto number = [](const UInt<4>& v) {
+        uint8_t bytes[32];
+        v.to_bytes_be(bytes);
+        return std::string(reinterpret_cast<const char*>(bytes), sizeof(bytes));
+    };
+    auto hash = [](const std::string& message) {
+        Streebog streebog(256);
+        streebog.update(message.data(), message.size());
+        uint8_t digest[32];
+        streebog.final(digest);
+        return UInt<4>::from_bytes_le(digest, sizeof(digest));
+    };
+    auto [x, y] = curve.coordinates(Q);
+    std::string key = number(x) + number(y);
+
+    {
+        ServerClient client(path);
+        struct stat st;
+        assert(lstat(path.c_str(), &st) == 0 && S_ISSOCK(st.st_mode) && (st.st_mode & 077) == 0);
+
+        // Запросы без ожидания ответов: ответы приходят в порядке запросов
+        std::vector<std::string> messages{"first", "second", std::string(100000, 'x'), ""};
+        for (uint32_t i = 0; i < messages.size(); ++i) client.send(server::kOpSign, 10 + i, messages[i]);
+        client.send(7, 20, "unknown operation");
+        client.send(server::kOpVerify, 21, "too short");
+
+        std::vector<std::pair<UInt<4>, UInt<4>>> signatures;
+        for (uint32_t i = 0; i < messages.size(); ++i) {
+            auto [status, id, data] = client.receive();
+            assert(status == server::kStatusOk && id == 10 + i && data.size() == 64);
+            auto bytes = reinterpret_cast<const uint8_t*>(data.data());
+            signatures.push_back({UInt<4>::from_bytes_be(bytes, 32), UInt<4>::from_bytes_be(bytes + 32, 32)});
+            assert(verify_signature(hash(messages[i]), signatures.back(), curve, Q));
+        }
+        auto [unknown_status, unknown_id, unknown_error] = client.receive();
+        assert(unknown_status == server::kStatusError && unknown_id == 20 && !unknown_error.empty());
+        auto [short_status, short_id, short_error] = client.receive();
+        assert(short_status == server::kStatusError && short_id == 21);
+
+        // Второе соединение проверяет подписи первого, пока первое остаётся открытым
+        ServerClient verifier(path);
+        for (uint32_t i = 0; i < messages.size(); ++i) {
+            std::string signature = number(signatures[i].first) + number(signatures[i].second);
+            verifier.send(server::kOpVerify, 2 * i, key + signature + messages[i]);
+            verifier.send(server::kOpVerify, 2 * i + 1, key + signature + messages[i] + "!");
+        }
+        for (uint32_t i = 0; i < 2 * messages.size(); ++i) {
+            auto [status, id, data] = verifier.receive();
+            assert(id == i && data.empty());
+            assert(status == (i % 2 == 0 ? server::kStatusOk : server::kStatusInvalid));
+        }
+        client.send(server::kOpSign, 30, "after verify");
+        assert(std::get<0>(client.receive()) == server::kStatusOk);
+    }
+
+    server::stop_requested = true;
+    service.join();
+    struct stat st;
+    assert(lstat(path.c_str(), &st) < 0);
+    std::cout << "[PASS] Signing service test" << std::endl;
+}
+
+int main() {
+    testStreebog();
+    testStandardExample();
+    testSignVerify<4>("tc26-256-A");
+    testSignVerify<8>("tc26-512-A");
+    testSignVerify<8>("tc26-512-C");
+    testBatchInversion<4>("tc26-256-A");
+    testBatchInversion<8>("tc26-512-A");
+    testBatchSign<4>("tc26-256-A");
+    testBatchSign<8>("tc26-512-A");
+    testNoncePool();
+    testBatchVerify();
+    testServer();
+    std::cout << "All tests passed.\n";
+    return 0;
+}
@@ -0,0 +1,172 @@
+// benchmark.h
+#ifndef CRYPTO_BENCHMARK_H
+#define CRYPTO_BENCHMARK_H
+
+// Общая часть замеров производительности bench_rsa и bench_gost: разбор параметров
+// командной строки, замер операции с распределением задержек и отчёт в JSON.
+//
+// Входные данные замеров (ключи, сообщения, одноразовые числа) выводятся из --seed,
+// поэтому два запуска с одним зерном выполняют одну и ту же работу, и разница
+// в отчётах отражает только скорость кода. Отчёт пишется в stdout или в --out=FILE.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace benchmark {
+
+struct Options {
+    uint64_t seed = 20240522;
+    bool quick = false;        // меньше повторов и меньшие размеры, для проверки в ctest
+    std::string output;        // пусто — stdout
+};
+
+inline Options parse_options(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], "--seed=", 7) == 0) {
+            options.seed = std::strtoull(argv[i] + 7, nullptr, 10);
+        } else if (std::strcmp(argv[i], "--quick") == 0) {
+            options.quick = true;
+        } else if (std::strncmp(argv[i], "--out=", 6) == 0) {
+            options.output = argv[i] + 6;
+        } else {
+            throw std::invalid_argument(std::string("Unknown option: ") + argv[i] +
+                                        " (expected --seed=N, --quick, --out=FILE)");
+        }
+    }
+    return options;
+}
+
+// Распределение времени одной операции, наносекунды
+struct Stats {
+    size_t iterations = 0;
+    double total_ns = 0;
+    double min_ns = 0;
+    double median_ns = 0;
+    double p90_ns = 0;
+    double p99_ns = 0;
+    double max_ns = 0;
+
+    double mean_ns() const { return iterations ? total_ns / iterations : 0; }
+    double ops_per_sec() const { return total_ns > 0 ? iterations * 1e9 / total_ns : 0; }
+};
+
+inline Stats summarize(std::vector<double> samples) {
+    Stats stats;
+    if (samples.empty()) return stats;
+    std::sort(samples.begin(), samples.end());
+    auto at = [&](double fraction) { return samples[static_cast<size_t>(fraction * (samples.size() - 1))]; };
+    stats.iterations = samples.size();
+    for (double ns : samples) stats.total_ns += ns;
+    stats.min_ns = samples.front();
+    stats.median_ns = at(0.5);
+    stats.p90_ns = at(0.9);
+    stats.p99_ns = at(0.99);
+    stats.max_ns = samples.back();
+    return stats;
+}
+
+// Повторять body, пока не наберётся min_iterations вызовов и min_seconds времени
+// (но не больше max_iterations). Каждый вызов замеряется отдельно, поэтому body
+// должен быть не короче нескольких микросекунд.
+template <class Body>
+Stats measure(Body&& body, size_t min_iterations, double min_seconds, size_t max_iterations = 1000000) {
+    using Clock = std::chrono::steady_clock;
+    std::vector<double> samples;
+    double elapsed = 0;
+    while (samples.size() < max_iterations && (samples.size() < min_iterations || elapsed < min_seconds * 1e9)) {
+        auto start = Clock::now();
+        body();
+        double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        samples.push_back(ns);
+        elapsed += ns;
+    }
+    return summarize(std::move(samples));
+}
+
+// Результаты замеров: каждая запись — имя операции, её параметры и распределение времени.
+// Для операций над данными bytes задаёт объём одного вызова, из него считается пропускная способность;
+// для пакетных операций items — число запросов в одном вызове.
+class Report {
+public:
+    Report(std::string suite, const Options& options) : suite_(std::move(suite)), options_(options) {}
+
+    void add(const std::string& name, std::vector<std::pair<std::string, std::string>> params,
+             const Stats& stats, uint64_t bytes = 0, uint64_t items = 1) {
+        std::cerr << suite_ << ": " << name;
+        for (const auto& [key, value] : params) std::cerr << ' ' << key << '=' << value;
+        std::cerr << ": " << stats.ops_per_sec() << " ops/s\n";
+        entries_.push_back({name, std::move(params), stats, bytes, items});
+    }
+
+    void write() const {
+        if (options_.output.empty()) {
+            write_json(std::cout);
+            return;
+        }
+        std::ofstream out(options_.output);
+        if (!out) throw std::runtime_error("Cannot write report: " + options_.output);
+        write_json(out);
+    }
+
+    void write_json(std::ostream& out) const {
+        out << "{\n  \"suite\": \"" << suite_ << "\",\n  \"seed\": " << options_.seed
+            << ",\n  \"quick\": " << (options_.quick ? "true" : "false") << ",\n  \"results\": [";
+        const char* sep = "\n";
+        for (const auto& entry : entries_) {
+            const Stats& s = entry.stats;
+            out << sep << "    {\"name\": \"" << entry.name << "\", \"params\": {";
+            const char* param_sep = "";
+            for (const auto& [key, value] : entry.params) {
+                out << param_sep << "\"" << key << "\": \"" << value << "\"";
+                param_sep = ", ";
+            }
+            out << "}, \"iterations\": " << s.iterations << ", \"ops_per_sec\": " << s.ops_per_sec()
+                << ", \"mean_ns\": " << s.mean_ns() << ", \"min_ns\": " << s.min_ns
+                << ", \"median_ns\": " << s.median_ns << ", \"p90_ns\": " << s.p90_ns
+                << ", \"p99_ns\": " << s.p99_ns << ", \"max_ns\": " << s.max_ns;
+            if (entry.bytes) {
+                out << ", \"bytes\": " << entry.bytes
+                    << ", \"mb_per_sec\": " << entry.bytes * s.ops_per_sec() / 1e6;
+            }
+            if (entry.items > 1) {
+                out << ", \"items\": " << entry.items << ", \"items_per_sec\": " << entry.items * s.ops_per_sec();
+            }
+            out << "}";
+            sep = ",\n";
+        }
+        out << "\n  ]\n}\n";
+    }
+
+private:
+    struct Entry {
+        std::string name;
+        std::vector<std::pair<std::string, std::string>> params;
+        Stats stats;
+        uint64_t bytes;
+        uint64_t items;
+    };
+
+    std::string suite_;
+    Options options_;
+    std::vector<Entry> entries_;
+};
+
+// Не даёт компилятору выбросить вычисление, результат которого не используется
+template <class T>
+inline void do_not_optimize(const T& value) {
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+} // namespace benchmark
+
+#endif // CRYPTO_BENCHMARK_H
@@ -0,0 +1,162 @@
+// instrumentation.h
+#ifndef CRYPTO_INSTRUMENTATION_H
+#define CRYPTO_INSTRUMENTATION_H
+
+// Замеры этапов (чтение, дополнение, хэш, развёртка ключа, обработка блоков, возведение
+// в степень, скалярное умножение, запись) для magma_main, RSA и gost_sign.
+//
+// Сборка с -DCRYPTO_STATS включает таймеры и счётчики; без неё макросы INSTRUMENT_*
+// раскрываются в пустые выражения и не оставляют в коде ни обращений к часам, ни атомиков.
+// Флаг --stats печатает JSON в stderr при завершении программы, --stats=FILE — в файл.
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#ifdef CRYPTO_STATS
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#endif
+
+namespace instrumentation {
+
+#ifdef CRYPTO_STATS
+
+struct Metric {
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> nanoseconds{0};   // только для таймеров
+};
+
+// Реестр метрик процесса. Адрес метрики не меняется, поэтому макросы находят её
+// по имени один раз и дальше обновляют без блокировок.
+class Registry {
+public:
+    static Registry& instance() {
+        static Registry registry;
+        return registry;
+    }
+
+    Metric& timer(const char* name) { return get(timers_, name); }
+    Metric& counter(const char* name) { return get(counters_, name); }
+
+    void write_json(std::ostream& out) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        out << "{\"timers\": {";
+        const char* sep = "";
+        for (const auto& [name, metric] : timers_) {
+            out << sep << "\"" << name << "\": {\"calls\": " << metric->count.load()
+                << ", \"total_ns\": " << metric->nanoseconds.load() << "}";
+            sep = ", ";
+        }
+        out << "}, \"counters\": {";
+        sep = "";
+        for (const auto& [name, metric] : counters_) {
+            out << sep << "\"" << name << "\": " << metric->count.load();
+            sep = ", ";
+        }
+        out << "}}\n";
+    }
+
+private:
+    using Metrics = std::map<std::string, std::unique_ptr<Metric>>;
+
+    Metric& get(Metrics& metrics, const char* name) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto& slot = metrics[name];
+        if (!slot) slot = std::make_unique<Metric>();
+        return *slot;
+    }
+
+    mutable std::mutex mutex_;
+    Metrics timers_, counters_;
+};
+
+class ScopedTimer {
+public:
+    explicit ScopedTimer(Metric& metric) : metric_(metric), start_(std::chrono::steady_clock::now()) {}
+    ~ScopedTimer() {
+        auto elapsed = std::chrono::steady_clock::now() - start_;
+        metric_.count.fetch_add(1, std::memory_order_relaxed);
+        metric_.nanoseconds.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count(),
+                                      std::memory_order_relaxed);
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    Metric& metric_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+#define INSTRUMENT_CONCAT_IMPL(a, b) a##b
+#define INSTRUMENT_CONCAT(a, b) INSTRUMENT_CONCAT_IMPL(a, b)
+
+// Замер времени до конца текущей области видимости
+#define INSTRUMENT_SCOPE(name)                                                                        \
+    static ::instrumentation::Metric& INSTRUMENT_CONCAT(instrument_metric_, __LINE__) =               \
+        ::instrumentation::Registry::instance().timer(name);                                          \
+    ::instrumentation::ScopedTimer INSTRUMENT_CONCAT(instrument_timer_, __LINE__)(                    \
+        INSTRUMENT_CONCAT(instrument_metric_, __LINE__))
+
+// Увеличение счётчика на n
+#define INSTRUMENT_COUNT(name, n)                                                                     \
+    do {                                                                                              \
+        static ::instrumentation::Metric& instrument_counter =                                        \
+            ::instrumentation::Registry::instance().counter(name);                                    \
+        instrument_counter.count.fetch_add(static_cast<uint64_t>(n), std::memory_order_relaxed);      \
+    } while (0)
+
+#else
+
+#define INSTRUMENT_SCOPE(name) static_cast<void>(0)
+#define INSTRUMENT_COUNT(name, n) static_cast<void>(0)
+
+#endif // CRYPTO_STATS
+
+// Разбор --stats / --stats=FILE из аргументов main и вывод JSON при выходе из области видимости
+class Session {
+public:
+    Session(int argc, char* argv[]) {
+        for (int i = 1; i < argc; ++i) {
+            if (std::strcmp(argv[i], "--stats") == 0) {
+                enabled_ = true;
+            } else if (std::strncmp(argv[i], "--stats=", 8) == 0) {
+                enabled_ = true;
+                path_ = argv[i] + 8;
+            }
+        }
+#ifndef CRYPTO_STATS
+        if (enabled_) std::cerr << "--stats: built without CRYPTO_STATS, no statistics collected\n";
+        enabled_ = false;
+#endif
+    }
+
+    ~Session() {
+#ifdef CRYPTO_STATS
+        if (!enabled_) return;
+        if (path_.empty()) {
+            Registry::instance().write_json(std::cerr);
+        } else {
+            std::ofstream out(path_);
+            Registry::instance().write_json(out);
+        }
+#endif
+    }
+
+    Session(const Session&) = delete;
+    Session& operator=(const Session&) = delete;
+
+private:
+    bool enabled_ = false;
+    std::string path_;
+};
+
+} // namespace instrumentation
+
+#endif // CRYPTO_INSTRUMENTATION_H